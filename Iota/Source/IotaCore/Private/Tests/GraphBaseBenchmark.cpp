@@ -0,0 +1,266 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#include "IotaCore/GraphBase.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GraphBaseBenchmark
+{
+	/**
+	 * Copy of the graph layout that TGraphBase used before adopting compressed sparse row
+	 * adjacency, kept only to measure traversals against. Every node is a separate heap object
+	 * holding its own edge array, and every edge pair shares a separately allocated data object.
+	 */
+	template <typename NodeData, typename EdgeData = int32>
+	class TPointerGraph
+	{
+
+	public:
+
+		struct FGraphNode;
+
+		struct FGraphEdge
+		{
+			TWeakPtr<FGraphNode> Connection;
+			int32 ConnectionIndex = INDEX_NONE;
+			TSharedPtr<EdgeData> Data;
+
+			FGraphEdge(const TSharedPtr<FGraphNode>& InConnection, int32 InConnectionIndex)
+				: Connection(InConnection)
+				, ConnectionIndex(InConnectionIndex)
+			{
+				// Complete constructor.
+			}
+		};
+
+		struct FGraphNode
+		{
+			TArray<FGraphEdge> Edges;
+			TUniquePtr<NodeData> Data;
+
+			template <typename... NodeDataParams>
+			FGraphNode(NodeDataParams&&... Params)
+			{
+				Data = MakeUnique<NodeData>(Params...);
+			}
+
+			int32 GetDegree() const
+			{
+				return Edges.Num();
+			}
+
+			int32 GetConnectionIndex(int32 Index) const
+			{
+				return Edges[Index].ConnectionIndex;
+			}
+
+			EdgeData& GetEdgeData(int32 Index) const
+			{
+				return *Edges[Index].Data;
+			}
+		};
+
+		template <typename... NodeDataParams>
+		int32 MakeNode(NodeDataParams&&... Params)
+		{
+			return Nodes.Emplace(MakeShared<FGraphNode>(Params...));
+		}
+
+		template <typename... EdgeDataParams>
+		EdgeData& MakeEdge(int32 NodeIndexA, int32 NodeIndexB, EdgeDataParams&&... Params)
+		{
+			int32 EdgeIndexA = Nodes[NodeIndexA]->Edges.Emplace(Nodes[NodeIndexB], NodeIndexB);
+			int32 EdgeIndexB = Nodes[NodeIndexB]->Edges.Emplace(Nodes[NodeIndexA], NodeIndexA);
+
+			TSharedPtr<EdgeData> NewEdgeData = MakeShared<EdgeData>(Params...);
+			Nodes[NodeIndexA]->Edges[EdgeIndexA].Data = NewEdgeData;
+			Nodes[NodeIndexB]->Edges[EdgeIndexB].Data = NewEdgeData;
+
+			return *NewEdgeData;
+		}
+
+		int32 GetSize() const
+		{
+			return Nodes.Num();
+		}
+
+		const FGraphNode& GetNode(int32 Index) const
+		{
+			return *Nodes[Index];
+		}
+
+	private:
+
+		TArray<TSharedPtr<FGraphNode>> Nodes;
+	};
+
+	/**
+	 * Builds a random spanning tree with extra cross links, shaped like a large tile map. The
+	 * same seed builds the same graph in either layout.
+	 *
+	 * @param Graph Empty graph to fill.
+	 * @param NumNodes Number of nodes to create.
+	 * @param Seed Seed for the random links.
+	 */
+	template <typename GraphType>
+	void BuildGraph(GraphType& Graph, int32 NumNodes, int32 Seed)
+	{
+		FRandomStream Stream(Seed);
+
+		for (int32 Index = 0; Index < NumNodes; Index++)
+		{
+			Graph.MakeNode(Index);
+		}
+
+		for (int32 Index = 1; Index < NumNodes; Index++)
+		{
+			Graph.MakeEdge(Index, Stream.RandRange(FMath::Max(0, Index - 8), Index - 1), Stream.RandRange(1, 9));
+		}
+
+		for (int32 Link = 0; Link < NumNodes / 4; Link++)
+		{
+			int32 NodeA = Stream.RandRange(0, NumNodes - 1);
+			int32 NodeB = Stream.RandRange(0, NumNodes - 1);
+
+			if (NodeA != NodeB)
+			{
+				Graph.MakeEdge(NodeA, NodeB, Stream.RandRange(1, 9));
+			}
+		}
+	}
+
+	/**
+	 * Walks the whole graph breadth first from the given node through the node and edge accessors
+	 * that both layouts share, reusing the caller's buffers between walks.
+	 *
+	 * @return Sum of the edge data on every edge crossed, to compare the layouts.
+	 */
+	template <typename GraphType>
+	int64 WalkBreadthFirst(const GraphType& Graph, int32 Source, TArray<int32>& Distances, TArray<int32>& Queue)
+	{
+		Distances.Init(INDEX_NONE, Graph.GetSize());
+		Queue.Reset();
+
+		Distances[Source] = 0;
+		Queue.Add(Source);
+
+		int64 Checksum = 0;
+
+		for (int32 Head = 0; Head < Queue.Num(); Head++)
+		{
+			const auto& Node = Graph.GetNode(Queue[Head]);
+
+			for (int32 Edge = 0; Edge < Node.GetDegree(); Edge++)
+			{
+				int32 Neighbor = Node.GetConnectionIndex(Edge);
+
+				if (Distances[Neighbor] == INDEX_NONE)
+				{
+					Distances[Neighbor] = Distances[Queue[Head]] + 1;
+					Checksum += Node.GetEdgeData(Edge);
+					Queue.Add(Neighbor);
+				}
+			}
+		}
+
+		return Checksum;
+	}
+
+	/**
+	 * Visits the neighbors of every node's neighbors, as a game thread pass over the map would.
+	 *
+	 * @return Sum of the degrees of every neighbor, to compare the layouts.
+	 */
+	template <typename GraphType>
+	int64 WalkNeighbors(const GraphType& Graph)
+	{
+		int64 Checksum = 0;
+
+		for (int32 Index = 0; Index < Graph.GetSize(); Index++)
+		{
+			const auto& Node = Graph.GetNode(Index);
+
+			for (int32 Edge = 0; Edge < Node.GetDegree(); Edge++)
+			{
+				Checksum += Graph.GetNode(Node.GetConnectionIndex(Edge)).GetDegree();
+			}
+		}
+
+		return Checksum;
+	}
+
+	/**
+	 * Runs a walk repeatedly and returns the average time per walk.
+	 *
+	 * @return Average walk time in microseconds.
+	 */
+	template <typename WalkFunc>
+	double TimeWalk(int32 Repeats, int64& OutChecksum, WalkFunc&& Walk)
+	{
+		// Warm the caches and buffers first so that only steady state walks are measured.
+		OutChecksum = Walk();
+		double StartTime = FPlatformTime::Seconds();
+
+		for (int32 Repeat = 0; Repeat < Repeats; Repeat++)
+		{
+			OutChecksum = Walk();
+		}
+
+		return (FPlatformTime::Seconds() - StartTime) * 1000000.0 / Repeats;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGraphBaseLayoutBenchmark, "Iota.Core.GraphBase.LayoutBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FGraphBaseLayoutBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace GraphBaseBenchmark;
+
+	const int32 NodeCounts[] = { 256, 4096, 65536 };
+
+	for (int32 NumNodes : NodeCounts)
+	{
+		TPointerGraph<int32> PointerGraph;
+		TGraphBase<int32> FlatGraph;
+
+		BuildGraph(PointerGraph, NumNodes, NumNodes);
+		BuildGraph(FlatGraph, NumNodes, NumNodes);
+		FlatGraph.BuildAdjacency();
+
+		int32 Repeats = FMath::Max(4, 1048576 / NumNodes);
+		TArray<int32> Distances;
+		TArray<int32> Queue;
+		FGraphScratch Scratch;
+
+		int64 PointerSum = 0;
+		int64 FlatSum = 0;
+		int64 SearchSum = 0;
+
+		double PointerBfs = TimeWalk(Repeats, PointerSum, [&]() { return WalkBreadthFirst(PointerGraph, 0, Distances, Queue); });
+		double FlatBfs = TimeWalk(Repeats, FlatSum, [&]() { return WalkBreadthFirst(FlatGraph, 0, Distances, Queue); });
+		TestEqual(FString::Printf(TEXT("Breadth-first checksums match at %i nodes"), NumNodes), FlatSum, PointerSum);
+
+		const int32 Source = 0;
+
+		double SearchBfs = TimeWalk(Repeats, SearchSum, [&]()
+		{
+			FlatGraph.FindHopDistances(MakeArrayView(&Source, 1), Distances, Scratch);
+			return static_cast<int64>(Scratch.Queue.Num());
+		});
+
+		TestEqual(FString::Printf(TEXT("FindHopDistances reaches every node at %i nodes"), NumNodes), SearchSum, static_cast<int64>(Queue.Num()));
+
+		double PointerWalk = TimeWalk(Repeats, PointerSum, [&]() { return WalkNeighbors(PointerGraph); });
+		double FlatWalk = TimeWalk(Repeats, FlatSum, [&]() { return WalkNeighbors(FlatGraph); });
+		TestEqual(FString::Printf(TEXT("Neighbor walk checksums match at %i nodes"), NumNodes), FlatSum, PointerSum);
+
+		AddInfo(FString::Printf(TEXT("%i nodes: breadth first %.1f us pointer, %.1f us flat, %.1f us FindHopDistances; neighbor walk %.1f us pointer, %.1f us flat."),
+			NumNodes, PointerBfs, FlatBfs, SearchBfs, PointerWalk, FlatWalk));
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,181 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#include "IotaCore/GraphBase.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GraphBaseTest
+{
+	/** Edge weight callable that reads the integer weight stored on each edge. */
+	float EdgeWeight(int32 Weight)
+	{
+		return static_cast<float>(Weight);
+	}
+
+	/** Heuristic callable that turns every weighted search into Dijkstra's algorithm. */
+	float NoHeuristic(int32 Node)
+	{
+		return 0.0f;
+	}
+
+	/**
+	 * Builds a graph with the given number of nodes and one weighted edge per entry, made in
+	 * order so that edge indices follow the entries.
+	 */
+	void BuildGraph(TGraphBase<int32>& Graph, int32 NumNodes, const TArray<FIntVector>& Edges)
+	{
+		for (int32 Index = 0; Index < NumNodes; Index++)
+		{
+			Graph.MakeNode(Index);
+		}
+
+		for (const FIntVector& Edge : Edges)
+		{
+			Graph.MakeEdge(Edge.X, Edge.Y, Edge.Z);
+		}
+	}
+
+	/** Checks an array against the expected values, element by element. */
+	template <typename ElementType>
+	void TestArray(FAutomationTestBase& Test, const FString& What, const TArray<ElementType>& Actual, const TArray<ElementType>& Expected)
+	{
+		if (!Test.TestEqual(FString::Printf(TEXT("%s count"), *What), Actual.Num(), Expected.Num()))
+		{
+			return;
+		}
+
+		for (int32 Index = 0; Index < Expected.Num(); Index++)
+		{
+			Test.TestEqual(FString::Printf(TEXT("%s [%i]"), *What, Index), Actual[Index], Expected[Index]);
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGraphBaseCutsTest, "Iota.Core.GraphBase.Cuts", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGraphBaseCutsTest::RunTest(const FString& Parameters)
+{
+	using namespace GraphBaseTest;
+
+	// A triangle with a pendant node hanging off one corner. The cycle edges all have another
+	// way around, so only the pendant edge is a bridge, and only the corner holding it cuts.
+	TGraphBase<int32> Graph;
+	BuildGraph(Graph, 4, { { 0, 1, 1 }, { 1, 2, 1 }, { 2, 0, 1 }, { 2, 3, 1 } });
+
+	FGraphScratch Scratch;
+	TArray<int32> Result;
+
+	Graph.FindArticulationPoints(Result, Scratch);
+	TestArray<int32>(*this, TEXT("Articulation points"), Result, { 2 });
+
+	Graph.FindBridges(Result, Scratch);
+	TestArray<int32>(*this, TEXT("Bridges"), Result, { 3 });
+
+	// A doubled pendant edge forms a cycle of its own, so neither copy is a bridge any more, but
+	// the pendant still hangs off the same corner.
+	Graph.MakeEdge(3, 2, 1);
+
+	Graph.FindBridges(Result, Scratch);
+	TestArray<int32>(*this, TEXT("Bridges with a doubled edge"), Result, {});
+
+	Graph.FindArticulationPoints(Result, Scratch);
+	TestArray<int32>(*this, TEXT("Articulation points with a doubled edge"), Result, { 2 });
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGraphBaseComponentsTest, "Iota.Core.GraphBase.Components", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGraphBaseComponentsTest::RunTest(const FString& Parameters)
+{
+	using namespace GraphBaseTest;
+
+	// A path of three nodes, a separate pair, and an isolated node.
+	TGraphBase<int32> Graph;
+	BuildGraph(Graph, 6, { { 0, 1, 1 }, { 1, 2, 1 }, { 3, 4, 1 } });
+
+	FGraphScratch Scratch;
+	TArray<int32> Components;
+
+	TestEqual(TEXT("Component count"), Graph.FindComponents(Components, Scratch), 3);
+	TestArray<int32>(*this, TEXT("Component labels"), Components, { 0, 0, 0, 1, 1, 2 });
+
+	// Every edge in a forest is a bridge, and every inner path node is a cut.
+	TArray<int32> Result;
+
+	Graph.FindBridges(Result, Scratch);
+	Result.Sort();
+	TestArray<int32>(*this, TEXT("Bridges"), Result, { 0, 1, 2 });
+
+	Graph.FindArticulationPoints(Result, Scratch);
+	TestArray<int32>(*this, TEXT("Articulation points"), Result, { 1 });
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGraphBaseUnreachableTest, "Iota.Core.GraphBase.Unreachable", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGraphBaseUnreachableTest::RunTest(const FString& Parameters)
+{
+	using namespace GraphBaseTest;
+
+	// Two separate pairs, so nothing in one pair can reach the other.
+	TGraphBase<int32> Graph;
+	BuildGraph(Graph, 4, { { 0, 1, 2 }, { 2, 3, 2 } });
+
+	FGraphScratch Scratch;
+	TArray<int32> Path = { 7 };
+
+	TestFalse(TEXT("Path to an unreachable goal is found"), Graph.FindPath(0, 3, EdgeWeight, NoHeuristic, Path, Scratch));
+	TestTrue(TEXT("Path to an unreachable goal is empty"), Path.IsEmpty());
+
+	TArray<float> Costs;
+	Graph.FindPathCosts(0, EdgeWeight, Costs, Scratch);
+	TestArray<float>(*this, TEXT("Path costs"), Costs, { 0.0f, 2.0f, TNumericLimits<float>::Max(), TNumericLimits<float>::Max() });
+
+	const int32 Source = 0;
+	TArray<int32> Distances;
+	Graph.FindHopDistances(MakeArrayView(&Source, 1), Distances, Scratch);
+	TestArray<int32>(*this, TEXT("Hop distances"), Distances, { 0, 1, INDEX_NONE, INDEX_NONE });
+
+	// The reachable goal in the same pair is still found.
+	TestTrue(TEXT("Path to a reachable goal is found"), Graph.FindPath(0, 1, EdgeWeight, NoHeuristic, Path, Scratch));
+	TestArray<int32>(*this, TEXT("Path to a reachable goal"), Path, { 0, 1 });
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGraphBaseMultiGoalTest, "Iota.Core.GraphBase.MultiGoal", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FGraphBaseMultiGoalTest::RunTest(const FString& Parameters)
+{
+	using namespace GraphBaseTest;
+
+	// Two branches leave node 0. The short branch reaches goal 2 in two expensive hops, and the
+	// long branch reaches goal 5 in three cheap hops.
+	TGraphBase<int32> Graph;
+	BuildGraph(Graph, 6, { { 0, 1, 5 }, { 1, 2, 5 }, { 0, 3, 1 }, { 3, 4, 1 }, { 4, 5, 1 } });
+
+	FGraphScratch Scratch;
+	TArray<int32> Path;
+
+	const int32 Source = 0;
+	const int32 Goals[] = { 2, 5 };
+
+	TestTrue(TEXT("Path to either goal is found"), Graph.FindPath(MakeArrayView(&Source, 1), MakeArrayView(Goals), EdgeWeight, NoHeuristic, Path, Scratch));
+	TestArray<int32>(*this, TEXT("Path to the cheaper goal"), Path, { 0, 3, 4, 5 });
+	TestEqual(TEXT("Cost of the cheaper goal"), Scratch.Costs[5], 3.0f);
+
+	// Alone, the expensive goal is still reached along its own branch.
+	TestTrue(TEXT("Path to the expensive goal is found"), Graph.FindPath(0, 2, EdgeWeight, NoHeuristic, Path, Scratch));
+	TestArray<int32>(*this, TEXT("Path to the expensive goal"), Path, { 0, 1, 2 });
+
+	TArray<float> Costs;
+	Graph.FindPathCosts(0, EdgeWeight, Costs, Scratch);
+	TestArray<float>(*this, TEXT("Path costs"), Costs, { 0.0f, 5.0f, 10.0f, 1.0f, 2.0f, 3.0f });
+
+	return true;
+}
+
+#endif
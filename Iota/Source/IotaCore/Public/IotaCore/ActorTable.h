@@ -176,6 +176,34 @@ public:
 		return TSubclassOf<ActorType>();
 	}
 
+	/**
+	 * Returns a random actor subtype associated with the provided key, selected using the given
+	 * random stream. Candidate subtypes are ordered by path name before selection so that equal
+	 * streams select equal subtypes regardless of asset discovery order. If no subtypes are found,
+	 * this method will return null.
+	 *
+	 * @param InKey Key for which to return a value.
+	 * @param Stream Random stream used to select the subtype.
+	 * @return Random actor subtype tied to the given key.
+	 */
+	TSubclassOf<ActorType> GetRandomSubtype(const KeyType& InKey, const FRandomStream& Stream) const
+	{
+		TArray<TSubclassOf<ActorType>> ValueList;
+		Table.MultiFind(InKey, ValueList);
+
+		if (!ValueList.IsEmpty())
+		{
+			ValueList.Sort([](const TSubclassOf<ActorType>& A, const TSubclassOf<ActorType>& B)
+			{
+				return A->GetPathName() < B->GetPathName();
+			});
+
+			return ValueList[Stream.RandRange(0, ValueList.Num() - 1)];
+		}
+
+		return TSubclassOf<ActorType>();
+	}
+
 	/**
 	 * Returns the number of entries currently collected in the actor table.
 	 *
@@ -3,10 +3,73 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Algo/Reverse.h"
+#include "Algo/Unique.h"
+
+/**
+ * Scratch buffers for graph queries. Buffers are reset between queries but keep their memory, so
+ * a caller that holds on to one scratch object can run repeated queries without allocating once
+ * the buffers have grown to fit the graph. A scratch object may only be used by one query at a
+ * time.
+ */
+struct FGraphScratch
+{
+	/** Nodes in the order they were reached by the last breadth-first search. */
+	TArray<int32> Queue;
+
+	/** Node or edge stack for depth-first searches. */
+	TArray<int32> Stack;
+
+	/** Previous node on the best known path to each node. */
+	TArray<int32> Parents;
+
+	/** Discovery order of each node in depth-first searches. */
+	TArray<int32> Order;
+
+	/** Lowest discovery order reachable from each node's subtree in depth-first searches. */
+	TArray<int32> Low;
+
+	/** Next adjacency entry to visit for each node in depth-first searches. */
+	TArray<int32> Cursors;
+
+	/** Best known path cost to each node. */
+	TArray<float> Costs;
+
+	/** Entry in the open set of a weighted search. */
+	struct FHeapEntry
+	{
+		/** Estimated total path cost through the node. */
+		float Priority;
+
+		/** Path cost to the node when the entry was pushed. */
+		float Cost;
+
+		/** Graph index of the node. */
+		int32 Node;
+
+		bool operator<(const FHeapEntry& Other) const
+		{
+			return Priority < Other.Priority;
+		}
+	};
+
+	/** Open set for weighted searches, ordered by estimated total cost. */
+	TArray<FHeapEntry> Heap;
+};
 
 /**
  * Implements an undirected graph structure that stores both nodes and edges as objects with data.
  *
+ * Node data is stored contiguously in node index order, and edge data is stored contiguously in
+ * fixed-size pages so that references to edge data stay valid as the graph grows. Adjacency is
+ * stored in compressed sparse row (CSR) form: a single array of (neighbor, edge) pairs grouped by
+ * node, plus an offset array marking where each node's group begins. Traversals therefore touch
+ * a handful of contiguous arrays rather than chasing a pointer per hop.
+ *
+ * The adjacency array is rebuilt lazily on the first read after nodes or edges are added, so
+ * graphs should be built up front and read afterwards. Reads are not thread safe while a rebuild
+ * is pending; call BuildAdjacency before sharing a graph between threads.
+ *
  * @param NodeData Data type to store within each graph node.
  * @param EdgeData Data type to store within each graph edge. Defaults to an integer weight value.
  */
@@ -20,27 +83,36 @@ public:
 	struct FGraphEdge;
 
 	/**
-	 * Graph node container. Each node container initializes with a unique data object defined by
-	 * the graph template parameters and keeps track of its neighbors via an array of edges.
+	 * Graph edge entry. Each entry represents a directed relationship from the node whose
+	 * adjacency group contains it to the node at the connection index. Every undirected edge is
+	 * stored as a mirrored pair of entries that share a single edge data object.
 	 */
-	struct FGraphNode
+	struct FGraphEdge
 	{
-		/** Edges directed out from this node. */
-		TArray<FGraphEdge> Edges;
+		/** Graph index of the node to which this edge is directed. */
+		int32 ConnectionIndex = INDEX_NONE;
 
-		/** Data stored within this node. */
-		TUniquePtr<NodeData> Data;
+		/** Index of the edge data shared within this edge. */
+		int32 EdgeIndex = INDEX_NONE;
+	};
 
+	/**
+	 * Lightweight view of a single graph node. Node views refer back into the graph that created
+	 * them, so they must not outlive it or be held across graph modifications.
+	 */
+	struct FGraphNode
+	{
 		/**
-		 * Constructs a new node container and initializes its node data object using the provided
-		 * parameters.
+		 * Constructs a new view of the node at the given index.
 		 *
-		 * @param Params Parameters to be forwarded to the node data object constructor.
+		 * @param InGraph Graph that owns the node.
+		 * @param InIndex Graph index of the node.
 		 */
-		template <typename... NodeDataParams>
-		FGraphNode(NodeDataParams&&... Params)
+		FGraphNode(const TGraphBase& InGraph, int32 InIndex)
+			: Graph(&InGraph)
+			, Index(InIndex)
 		{
-			Data = MakeUnique<NodeData>(Params...);
+			// Complete constructor.
 		}
 
 		/**
@@ -50,70 +122,73 @@ public:
 		 */
 		int32 GetDegree() const
 		{
-			return Edges.Num();
+			return Graph->Offsets[Index + 1] - Graph->Offsets[Index];
 		}
 
 		/**
-		 * Returns a constant reference to the edge container stored at the provided edge index.
+		 * Returns a constant reference to the edge entry stored at the provided edge index.
 		 *
-		 * @param Index Edge index for which to return a reference.
-		 * @return Edge container stored at the provided index.
+		 * @param Edge Edge index for which to return a reference.
+		 * @return Edge entry stored at the provided index.
 		 */
-		const FGraphEdge& GetEdge(int32 Index) const
+		const FGraphEdge& GetEdge(int32 Edge) const
 		{
-			return Edges[Index];
+			checkSlow(0 <= Edge && Edge < GetDegree());
+			return Graph->Adjacency[Graph->Offsets[Index] + Edge];
 		}
 
 		/**
-		 * Returns a constant reference to the node container tied to the provided edge index.
+		 * Returns a view of the node tied to the provided edge index.
 		 *
-		 * @param Index Edge index for which to return a reference.
-		 * @return Node container tied to the provided index.
+		 * @param Edge Edge index for which to return a node.
+		 * @return Node tied to the provided index.
 		 */
-		const FGraphNode& GetConnection(int32 Index) const
+		FGraphNode GetConnection(int32 Edge) const
 		{
-			return *GetEdge(Index).Connection.Pin();
+			return FGraphNode(*Graph, GetConnectionIndex(Edge));
 		}
 
 		/**
-		 * Returns a mutable reference to the edge data object tied to the provided edge index.
+		 * Returns the graph index of the node tied to the provided edge index.
 		 *
-		 * @param Index Edge index for which to return a reference.
-		 * @return Edge data object tied to the provided index.
+		 * @param Edge Edge index for which to return a node index.
+		 * @return Graph index of the node tied to the provided index.
 		 */
-		EdgeData& GetEdgeData(int32 Index) const
+		int32 GetConnectionIndex(int32 Edge) const
 		{
-			return *GetEdge(Index).Data;
+			return GetEdge(Edge).ConnectionIndex;
 		}
-	};
-
-	/**
-	 * Graph edge container. Each edge container represents a directed relationship between two
-	 * nodes where only the destination node is known. Edge containers are therefore created in
-	 * mirrored pairs to simulate undirected behavior.
-	 *
-	 * Each pair initializes with a shared data object defined by the graph template parameters,
-	 * and each edge container tracks its connected node via a weak pointer.
-	 */
-	struct FGraphEdge
-	{
-		/** Node to which this edge is directed. */
-		TWeakPtr<FGraphNode> Connection;
-
-		/** Data shared within this edge. */
-		TSharedPtr<EdgeData> Data;
 
 		/**
-		 * Constructs a new edge container directed at the provided node address but does not
-		 * initialize its data. Edge data objects should be shared across edge container pairs,
-		 * so they should be constructed externally and assigned into each edge individually.
+		 * Returns a mutable reference to the edge data object tied to the provided edge index.
 		 *
-		 * @param InConnection Node to which the new edge will be directed.
+		 * @param Edge Edge index for which to return a reference.
+		 * @return Edge data object tied to the provided index.
 		 */
-		FGraphEdge(const TSharedPtr<FGraphNode>& InConnection) : Connection(InConnection)
+		EdgeData& GetEdgeData(int32 Edge) const
 		{
-			// Complete constructor.
+			return Graph->GetEdgeDataAt(GetEdge(Edge).EdgeIndex);
+		}
+
+		/** @return Mutable reference to the data stored within this node. */
+		NodeData& GetData() const
+		{
+			return const_cast<NodeData&>(Graph->Nodes[Index]);
 		}
+
+		/** @return Graph index of this node. */
+		int32 GetIndex() const
+		{
+			return Index;
+		}
+
+	private:
+
+		/** Graph that owns the node. */
+		const TGraphBase* Graph;
+
+		/** Graph index of the node. */
+		int32 Index;
 	};
 
 	TGraphBase()
@@ -127,8 +202,21 @@ public:
 	}
 
 	/**
-	 * Creates a new node container, adds it to the graph, and then initializes its node data
-	 * object using the provided parameters.
+	 * Reserves memory for the given number of nodes and edges, so that a graph of known size can
+	 * be built without reallocating.
+	 *
+	 * @param NumNodes Number of nodes to reserve.
+	 * @param NumEdges Number of undirected edges to reserve.
+	 */
+	void Reserve(int32 NumNodes, int32 NumEdges)
+	{
+		Nodes.Reserve(NumNodes);
+		EdgeEnds.Reserve(NumEdges);
+	}
+
+	/**
+	 * Creates a new node, adds it to the graph, and then initializes its node data object using
+	 * the provided parameters.
 	 *
 	 * @param Params Parameters to be forwarded to the node data object constructor.
 	 * @return Index of the new node.
@@ -136,12 +224,14 @@ public:
 	template <typename... NodeDataParams>
 	int32 MakeNode(NodeDataParams&&... Params)
 	{
-		return Nodes.Emplace(MakeShared<FGraphNode>(Params...));
+		bAdjacencyDirty = true;
+		return Nodes.Emplace(Forward<NodeDataParams>(Params)...);
 	}
 
 	/**
-	 * Creates a new pair of edge containers, adds them to the graph, and then initializes and
-	 * returns their shared edge data object using the provided parameters.
+	 * Creates a new edge between two nodes, adds it to the graph, and then initializes and
+	 * returns its edge data object using the provided parameters. The returned reference stays
+	 * valid until the graph is emptied.
 	 *
 	 * @param NodeIndexA Graph index of the first node to connect.
 	 * @param NodeIndexB Graph index of the second node to connect.
@@ -153,20 +243,20 @@ public:
 	{
 		// Disallow loops.
 		check(NodeIndexA != NodeIndexB);
+		check(Nodes.IsValidIndex(NodeIndexA) && Nodes.IsValidIndex(NodeIndexB));
 
-		// Create an empty pair of mirrored edges on each of the indexed nodes.
-		int32 EdgeIndexA = Nodes[NodeIndexA]->Edges.Emplace(Nodes[NodeIndexB]);
-		int32 EdgeIndexB = Nodes[NodeIndexB]->Edges.Emplace(Nodes[NodeIndexA]);
+		// Record the edge ends. The adjacency array picks them up on its next rebuild.
+		int32 EdgeIndex = EdgeEnds.Emplace(NodeIndexA, NodeIndexB);
+		bAdjacencyDirty = true;
 
-		// Create the new edge data object and pass in the parameters.
-		TSharedPtr<EdgeData> NewEdgeData = MakeShared<EdgeData>(Params...);
-
-		// Load the shared edge data object into each new edge.
-		Nodes[NodeIndexA]->Edges[EdgeIndexA].Data = NewEdgeData;
-		Nodes[NodeIndexB]->Edges[EdgeIndexB].Data = NewEdgeData;
+		// Start a new page whenever the last one is full. Pages never grow past their reserved
+		// size, so existing edge data never moves.
+		if (EdgeIndex % EdgePageSize == 0)
+		{
+			EdgePages.AddDefaulted_GetRef().Reserve(EdgePageSize);
+		}
 
-		// Return the data.
-		return *NewEdgeData;
+		return EdgePages.Last().Emplace_GetRef(Forward<EdgeDataParams>(Params)...);
 	}
 
 	/**
@@ -189,15 +279,23 @@ public:
 		return Nodes.Num();
 	}
 
+	/** @return Number of undirected edges currently stored within the graph. */
+	int32 GetEdgeCount() const
+	{
+		return EdgeEnds.Num();
+	}
+
 	/**
-	 * Returns a constant reference to the node container stored at the provided node index.
+	 * Returns a view of the node stored at the provided node index.
 	 *
-	 * @param Index Node index for which to return a reference.
-	 * @return Node container stored at the provided index.
+	 * @param Index Node index for which to return a node.
+	 * @return Node stored at the provided index.
 	 */
-	const FGraphNode& GetNode(int32 Index) const
+	FGraphNode GetNode(int32 Index) const
 	{
-		return *Nodes[Index];
+		check(Nodes.IsValidIndex(Index));
+		RebuildAdjacency();
+		return FGraphNode(*this, Index);
 	}
 
 	/**
@@ -208,17 +306,511 @@ public:
 	 */
 	NodeData& GetNodeData(int32 Index) const
 	{
-		return *GetNode(Index).Data;
+		return const_cast<NodeData&>(Nodes[Index]);
+	}
+
+	/**
+	 * Returns a mutable reference to the edge data object stored at the provided edge index.
+	 * Edge indices follow the order in which edges were made.
+	 *
+	 * @param EdgeIndex Edge index for which to return a reference.
+	 * @return Edge data object stored at the provided index.
+	 */
+	EdgeData& GetEdgeDataAt(int32 EdgeIndex) const
+	{
+		return const_cast<EdgeData&>(EdgePages[EdgeIndex / EdgePageSize][EdgeIndex % EdgePageSize]);
+	}
+
+	/**
+	 * Brings the adjacency array up to date now rather than on the next read. Once it is up to
+	 * date, the graph may be read from any number of threads at once until it is next modified.
+	 */
+	void BuildAdjacency() const
+	{
+		RebuildAdjacency();
 	}
 
 	/** Empties the graph and discards all graph data. */
 	virtual void Empty()
 	{
 		Nodes.Empty();
+		EdgeEnds.Empty();
+		EdgePages.Empty();
+		Offsets.Empty();
+		Adjacency.Empty();
+		bAdjacencyDirty = true;
+	}
+
+	/**
+	 * Returns a scratch object owned by the calling thread, for callers that do not keep their own.
+	 * Queries that run inside other queries on the same thread must use a separate scratch object.
+	 *
+	 * @return Scratch object for the calling thread.
+	 */
+	static FGraphScratch& GetThreadScratch()
+	{
+		static thread_local FGraphScratch ThreadScratch;
+		return ThreadScratch;
+	}
+
+	/**
+	 * Finds the number of edges on the shortest path from the nearest source to every node, using
+	 * a breadth-first search. Unreachable nodes, and nodes further than the hop limit, are given a
+	 * distance of INDEX_NONE. On return, the scratch queue lists every reached node in order of
+	 * distance.
+	 *
+	 * @param Sources Graph indices of the nodes to search from.
+	 * @param OutDistances Hop distance to each node, indexed by node index.
+	 * @param Scratch Scratch buffers for the search.
+	 * @param MaxHops Maximum number of hops to search.
+	 */
+	void FindHopDistances(TArrayView<const int32> Sources, TArray<int32>& OutDistances, FGraphScratch& Scratch, int32 MaxHops = MAX_int32) const
+	{
+		ResetArray(OutDistances, Nodes.Num(), int32(INDEX_NONE));
+		SearchHops(Sources, OutDistances.GetData(), Scratch, MaxHops);
+	}
+
+	/**
+	 * Finds the hop distance between every pair of nodes, stored as a square matrix in row order.
+	 * The distance from node A to node B is found at A * GetSize() + B. The matrix must fit in a
+	 * single array, which limits the graph to 46340 nodes.
+	 *
+	 * @param OutDistances Hop distance matrix, with INDEX_NONE for unreachable pairs.
+	 * @param Scratch Scratch buffers for the search.
+	 */
+	void FindAllHopDistances(TArray<int32>& OutDistances, FGraphScratch& Scratch) const
+	{
+		const int32 Size = Nodes.Num();
+
+		// The matrix grows with the square of the graph, so make sure it still fits in an array.
+		const int64 MatrixSize = static_cast<int64>(Size) * Size;
+		check(MatrixSize <= MAX_int32);
+
+		ResetArray(OutDistances, static_cast<int32>(MatrixSize), int32(INDEX_NONE));
+
+		for (int32 Source = 0; Source < Size; Source++)
+		{
+			SearchHops(MakeArrayView(&Source, 1), OutDistances.GetData() + static_cast<int64>(Source) * Size, Scratch, MAX_int32);
+		}
+	}
+
+	/**
+	 * Finds the cost of the cheapest path from the source to every node, using Dijkstra's
+	 * algorithm. Unreachable nodes are given a cost of TNumericLimits<float>::Max().
+	 *
+	 * @param Source Graph index of the node to search from.
+	 * @param EdgeWeight Callable returning the non-negative float cost of crossing an edge, given
+	 *        its edge data.
+	 * @param OutCosts Path cost to each node, indexed by node index.
+	 * @param Scratch Scratch buffers for the search.
+	 */
+	template <typename WeightFunc>
+	void FindPathCosts(int32 Source, WeightFunc&& EdgeWeight, TArray<float>& OutCosts, FGraphScratch& Scratch) const
+	{
+		SearchWeighted(MakeArrayView(&Source, 1), TArrayView<const int32>(), EdgeWeight, [](int32) { return 0.0f; }, OutCosts, Scratch);
+	}
+
+	/**
+	 * Finds the cheapest path between two nodes, using an A* search. The heuristic must never
+	 * overestimate the remaining cost to the goal, or the path found may not be the cheapest.
+	 * Pass a heuristic that always returns zero to run Dijkstra's algorithm.
+	 *
+	 * @param Source Graph index of the node to search from.
+	 * @param Goal Graph index of the node to search for.
+	 * @param EdgeWeight Callable returning the non-negative float cost of crossing an edge, given
+	 *        its edge data.
+	 * @param Heuristic Callable returning an estimate of the remaining cost from a node index to
+	 *        the goal.
+	 * @param OutPath Graph indices of the nodes along the path, from source to goal inclusive.
+	 * @param Scratch Scratch buffers for the search.
+	 * @return True if a path was found.
+	 */
+	template <typename WeightFunc, typename HeuristicFunc>
+	bool FindPath(int32 Source, int32 Goal, WeightFunc&& EdgeWeight, HeuristicFunc&& Heuristic, TArray<int32>& OutPath, FGraphScratch& Scratch) const
+	{
+		return FindPath(MakeArrayView(&Source, 1), MakeArrayView(&Goal, 1), EdgeWeight, Heuristic, OutPath, Scratch);
+	}
+
+	/**
+	 * Finds the cheapest path from any of the sources to any of the goals, using an A* search.
+	 * Goals are tested linearly, so the goal set should be small. The heuristic must never
+	 * overestimate the remaining cost to the nearest goal.
+	 *
+	 * @param Sources Graph indices of the nodes to search from. Every source starts at zero cost.
+	 * @param Goals Graph indices of the nodes to search for.
+	 * @param EdgeWeight Callable returning the non-negative float cost of crossing an edge, given
+	 *        its edge data.
+	 * @param Heuristic Callable returning an estimate of the remaining cost from a node index to
+	 *        the nearest goal.
+	 * @param OutPath Graph indices of the nodes along the path, from a source to a goal inclusive.
+	 * @param Scratch Scratch buffers for the search. On return, the scratch costs hold the cost of
+	 *        every node settled by the search.
+	 * @return True if a path was found.
+	 */
+	template <typename WeightFunc, typename HeuristicFunc>
+	bool FindPath(TArrayView<const int32> Sources, TArrayView<const int32> Goals, WeightFunc&& EdgeWeight, HeuristicFunc&& Heuristic, TArray<int32>& OutPath, FGraphScratch& Scratch) const
+	{
+		OutPath.Reset();
+
+		const int32 Goal = Goals.IsEmpty() ? INDEX_NONE : SearchWeighted(Sources, Goals, EdgeWeight, Heuristic, Scratch.Costs, Scratch);
+
+		if (Goal == INDEX_NONE)
+		{
+			return false;
+		}
+
+		// Walk back from the goal, then flip the path to run from the source.
+		for (int32 Node = Goal; Node != INDEX_NONE; Node = Scratch.Parents[Node])
+		{
+			OutPath.Add(Node);
+		}
+
+		Algo::Reverse(OutPath);
+		return true;
+	}
+
+	/**
+	 * Labels every node with the connected component that contains it.
+	 *
+	 * @param OutComponents Component label of each node, indexed by node index. Labels are
+	 *        numbered from zero in order of each component's lowest node index.
+	 * @param Scratch Scratch buffers for the search.
+	 * @return Number of connected components.
+	 */
+	int32 FindComponents(TArray<int32>& OutComponents, FGraphScratch& Scratch) const
+	{
+		ResetArray(OutComponents, Nodes.Num(), int32(INDEX_NONE));
+		RebuildAdjacency();
+
+		int32 NumComponents = 0;
+
+		for (int32 Root = 0; Root < Nodes.Num(); Root++)
+		{
+			if (OutComponents[Root] != INDEX_NONE)
+			{
+				continue;
+			}
+
+			Scratch.Queue.Reset();
+			Scratch.Queue.Add(Root);
+			OutComponents[Root] = NumComponents;
+
+			for (int32 Head = 0; Head < Scratch.Queue.Num(); Head++)
+			{
+				const int32 Node = Scratch.Queue[Head];
+
+				for (int32 Entry = Offsets[Node]; Entry < Offsets[Node + 1]; Entry++)
+				{
+					const int32 Connection = Adjacency[Entry].ConnectionIndex;
+
+					if (OutComponents[Connection] == INDEX_NONE)
+					{
+						OutComponents[Connection] = NumComponents;
+						Scratch.Queue.Add(Connection);
+					}
+				}
+			}
+
+			NumComponents++;
+		}
+
+		return NumComponents;
+	}
+
+	/**
+	 * Finds the articulation points of the graph: the nodes whose removal would split their
+	 * connected component in two or more.
+	 *
+	 * @param OutNodes Graph indices of every articulation point, in ascending order.
+	 * @param Scratch Scratch buffers for the search.
+	 */
+	void FindArticulationPoints(TArray<int32>& OutNodes, FGraphScratch& Scratch) const
+	{
+		OutNodes.Reset();
+		SearchCuts(&OutNodes, nullptr, Scratch);
+
+		// A node is reported once for each subtree it separates.
+		OutNodes.Sort();
+		OutNodes.SetNum(Algo::Unique(OutNodes), false);
+	}
+
+	/**
+	 * Finds the bridges of the graph: the edges whose removal would split their connected
+	 * component in two.
+	 *
+	 * @param OutEdges Edge indices of every bridge, usable with GetEdgeDataAt.
+	 * @param Scratch Scratch buffers for the search.
+	 */
+	void FindBridges(TArray<int32>& OutEdges, FGraphScratch& Scratch) const
+	{
+		OutEdges.Reset();
+		SearchCuts(nullptr, &OutEdges, Scratch);
+	}
+
+private:
+
+	/** Rebuilds the adjacency array if nodes or edges have been added since the last rebuild. */
+	void RebuildAdjacency() const
+	{
+		if (!bAdjacencyDirty)
+		{
+			return;
+		}
+
+		// Count the edges on each node, then convert the counts into running offsets.
+		Offsets.Reset();
+		Offsets.SetNumZeroed(Nodes.Num() + 1);
+
+		for (const TPair<int32, int32>& Ends : EdgeEnds)
+		{
+			Offsets[Ends.Key + 1]++;
+			Offsets[Ends.Value + 1]++;
+		}
+
+		for (int32 Index = 0; Index < Nodes.Num(); Index++)
+		{
+			Offsets[Index + 1] += Offsets[Index];
+		}
+
+		// Scatter each edge into both of its nodes' groups. Edges are visited in creation order, so
+		// each group lists its edges in the order they were made.
+		TArray<int32> Cursors(Offsets.GetData(), Nodes.Num());
+		Adjacency.SetNumUninitialized(EdgeEnds.Num() * 2);
+
+		for (int32 EdgeIndex = 0; EdgeIndex < EdgeEnds.Num(); EdgeIndex++)
+		{
+			const TPair<int32, int32>& Ends = EdgeEnds[EdgeIndex];
+
+			Adjacency[Cursors[Ends.Key]++] = { Ends.Value, EdgeIndex };
+			Adjacency[Cursors[Ends.Value]++] = { Ends.Key, EdgeIndex };
+		}
+
+		bAdjacencyDirty = false;
+	}
+
+	/** Resets the array to the given number of copies of a value, keeping its allocation. */
+	template <typename ElementType>
+	static void ResetArray(TArray<ElementType>& Array, int32 Num, const ElementType& Value)
+	{
+		Array.Reset(Num);
+		Array.AddUninitialized(Num);
+
+		for (ElementType& Element : Array)
+		{
+			Element = Value;
+		}
+	}
+
+	/**
+	 * Runs a breadth-first search from the given sources, filling in the hop distance of every
+	 * node reached. Distances must be initialized to INDEX_NONE.
+	 */
+	void SearchHops(TArrayView<const int32> Sources, int32* Distances, FGraphScratch& Scratch, int32 MaxHops) const
+	{
+		RebuildAdjacency();
+		Scratch.Queue.Reset();
+
+		for (int32 Source : Sources)
+		{
+			if (Nodes.IsValidIndex(Source) && Distances[Source] == INDEX_NONE)
+			{
+				Distances[Source] = 0;
+				Scratch.Queue.Add(Source);
+			}
+		}
+
+		for (int32 Head = 0; Head < Scratch.Queue.Num(); Head++)
+		{
+			const int32 Node = Scratch.Queue[Head];
+			const int32 Distance = Distances[Node] + 1;
+
+			if (MaxHops < Distance)
+			{
+				break;
+			}
+
+			for (int32 Entry = Offsets[Node]; Entry < Offsets[Node + 1]; Entry++)
+			{
+				const int32 Connection = Adjacency[Entry].ConnectionIndex;
+
+				if (Distances[Connection] == INDEX_NONE)
+				{
+					Distances[Connection] = Distance;
+					Scratch.Queue.Add(Connection);
+				}
+			}
+		}
+	}
+
+	/**
+	 * Runs a best-first search from the sources, filling in path costs and scratch parents. The
+	 * search stops early once any goal is settled, and otherwise settles every reachable node.
+	 *
+	 * @return Graph index of the goal reached, or INDEX_NONE if no goal was reached.
+	 */
+	template <typename WeightFunc, typename HeuristicFunc>
+	int32 SearchWeighted(TArrayView<const int32> Sources, TArrayView<const int32> Goals, WeightFunc&& EdgeWeight, HeuristicFunc&& Heuristic, TArray<float>& Costs, FGraphScratch& Scratch) const
+	{
+		ResetArray(Costs, Nodes.Num(), TNumericLimits<float>::Max());
+		ResetArray(Scratch.Parents, Nodes.Num(), int32(INDEX_NONE));
+		Scratch.Heap.Reset();
+
+		RebuildAdjacency();
+
+		for (int32 Source : Sources)
+		{
+			if (Nodes.IsValidIndex(Source) && 0.0f < Costs[Source])
+			{
+				Costs[Source] = 0.0f;
+				Scratch.Heap.HeapPush({ Heuristic(Source), 0.0f, Source });
+			}
+		}
+
+		while (!Scratch.Heap.IsEmpty())
+		{
+			FGraphScratch::FHeapEntry Open;
+			Scratch.Heap.HeapPop(Open, false);
+
+			// Nodes may be pushed more than once. Only the cheapest entry is expanded.
+			if (Costs[Open.Node] < Open.Cost)
+			{
+				continue;
+			}
+
+			if (Goals.Contains(Open.Node))
+			{
+				return Open.Node;
+			}
+
+			for (int32 Entry = Offsets[Open.Node]; Entry < Offsets[Open.Node + 1]; Entry++)
+			{
+				const FGraphEdge& Edge = Adjacency[Entry];
+				const float Weight = EdgeWeight(GetEdgeDataAt(Edge.EdgeIndex));
+				checkSlow(0.0f <= Weight);
+
+				const float Cost = Open.Cost + Weight;
+
+				if (Cost < Costs[Edge.ConnectionIndex])
+				{
+					Costs[Edge.ConnectionIndex] = Cost;
+					Scratch.Parents[Edge.ConnectionIndex] = Open.Node;
+					Scratch.Heap.HeapPush({ Cost + Heuristic(Edge.ConnectionIndex), Cost, Edge.ConnectionIndex });
+				}
+			}
+		}
+
+		return INDEX_NONE;
+	}
+
+	/**
+	 * Runs an iterative depth-first search over every component, reporting articulation points
+	 * and bridges as they are found. Articulation points may be reported more than once.
+	 */
+	void SearchCuts(TArray<int32>* OutNodes, TArray<int32>* OutEdges, FGraphScratch& Scratch) const
+	{
+		RebuildAdjacency();
+
+		ResetArray(Scratch.Order, Nodes.Num(), int32(INDEX_NONE));
+		ResetArray(Scratch.Low, Nodes.Num(), int32(INDEX_NONE));
+		ResetArray(Scratch.Parents, Nodes.Num(), int32(INDEX_NONE));
+		Scratch.Cursors.Reset(Nodes.Num());
+		Scratch.Cursors.Append(Offsets.GetData(), Nodes.Num());
+		Scratch.Stack.Reset();
+
+		int32 Counter = 0;
+
+		for (int32 Root = 0; Root < Nodes.Num(); Root++)
+		{
+			if (Scratch.Order[Root] != INDEX_NONE)
+			{
+				continue;
+			}
+
+			int32 RootChildren = 0;
+			Scratch.Order[Root] = Scratch.Low[Root] = Counter++;
+			Scratch.Stack.Push(Root);
+
+			while (!Scratch.Stack.IsEmpty())
+			{
+				const int32 Node = Scratch.Stack.Last();
+
+				// Descend along the next unvisited edge. Parents hold the edge each node was
+				// reached by rather than the parent node, so that doubled edges count as cycles.
+				if (Scratch.Cursors[Node] < Offsets[Node + 1])
+				{
+					const FGraphEdge& Edge = Adjacency[Scratch.Cursors[Node]++];
+					const int32 Connection = Edge.ConnectionIndex;
+
+					if (Edge.EdgeIndex == Scratch.Parents[Node])
+					{
+						continue;
+					}
+
+					if (Scratch.Order[Connection] == INDEX_NONE)
+					{
+						Scratch.Order[Connection] = Scratch.Low[Connection] = Counter++;
+						Scratch.Parents[Connection] = Edge.EdgeIndex;
+						Scratch.Stack.Push(Connection);
+						RootChildren += Node == Root;
+					}
+					else
+					{
+						Scratch.Low[Node] = FMath::Min(Scratch.Low[Node], Scratch.Order[Connection]);
+					}
+
+					continue;
+				}
+
+				// Every edge has been visited, so pass the lowest reachable order up to the parent.
+				Scratch.Stack.Pop(false);
+
+				if (Scratch.Stack.IsEmpty())
+				{
+					break;
+				}
+
+				const int32 Parent = Scratch.Stack.Last();
+				Scratch.Low[Parent] = FMath::Min(Scratch.Low[Parent], Scratch.Low[Node]);
+
+				if (OutEdges && Scratch.Order[Parent] < Scratch.Low[Node])
+				{
+					OutEdges->Add(Scratch.Parents[Node]);
+				}
+
+				if (OutNodes && Parent != Root && Scratch.Order[Parent] <= Scratch.Low[Node])
+				{
+					OutNodes->Add(Parent);
+				}
+			}
+
+			// The root separates its subtrees only if the search left it more than once.
+			if (OutNodes && 1 < RootChildren)
+			{
+				OutNodes->Add(Root);
+			}
+		}
 	}
 
 private:
 
-	/** Nodes stored within the graph. */
-	TArray<TSharedPtr<FGraphNode>> Nodes;
+	/** Number of edge data objects stored in each edge page. */
+	static constexpr int32 EdgePageSize = 64;
+
+	/** Node data objects, indexed by node index. */
+	TArray<NodeData> Nodes;
+
+	/** Node indices at both ends of each edge, indexed by edge index. */
+	TArray<TPair<int32, int32>> EdgeEnds;
+
+	/** Edge data objects in fixed-size pages, indexed by edge index. */
+	TArray<TArray<EdgeData>> EdgePages;
+
+	/** Offset of each node's group within the adjacency array, plus a final end offset. */
+	mutable TArray<int32> Offsets;
+
+	/** Edge entries grouped by the node they leave. */
+	mutable TArray<FGraphEdge> Adjacency;
+
+	/** True if the adjacency array is out of date. */
+	mutable bool bAdjacencyDirty = true;
 };
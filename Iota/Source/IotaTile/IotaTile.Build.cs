@@ -16,6 +16,9 @@ public class IotaTile : ModuleRules
 
 		// SPECIFIC MODULES
 		PublicDependencyModuleNames.Add("GameplayTags");
+		PublicDependencyModuleNames.Add("NavigationSystem");
+		PublicDependencyModuleNames.Add("NetCore");
+		PublicDependencyModuleNames.Add("ReplicationGraph");
 
 		// IOTA MODULES
 		PublicDependencyModuleNames.Add("IotaCore");
@@ -0,0 +1,9 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Logging/LogMacros.h"
+
+/** Log category for the tile generation and streaming systems. */
+DECLARE_LOG_CATEGORY_EXTERN(LogIotaTile, Log, All);
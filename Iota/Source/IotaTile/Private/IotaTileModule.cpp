@@ -1,5 +1,8 @@
 // Copyright Sydney Fonderie, 2023. All Rights Reserved.
 
 #include "Modules/ModuleManager.h"
+#include "IotaTileLog.h"
+
+DEFINE_LOG_CATEGORY(LogIotaTile);
 
 IMPLEMENT_MODULE(FDefaultModuleImpl, IotaTile);
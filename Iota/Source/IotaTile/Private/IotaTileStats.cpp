@@ -0,0 +1,12 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#include "IotaTileStats.h"
+
+UE_TRACE_CHANNEL_DEFINE(IotaTileChannel);
+
+LLM_DEFINE_TAG(IotaTile, NAME_None, NAME_None, GET_STATFNAME(STAT_IotaTileLLM), GET_STATFNAME(STAT_IotaTileSummaryLLM));
+LLM_DEFINE_TAG(IotaTile_Generator, NAME_None, TEXT("IotaTile"), GET_STATFNAME(STAT_IotaTile_GeneratorLLM), GET_STATFNAME(STAT_IotaTileSummaryLLM));
+LLM_DEFINE_TAG(IotaTile_Graph, NAME_None, TEXT("IotaTile"), GET_STATFNAME(STAT_IotaTile_GraphLLM), GET_STATFNAME(STAT_IotaTileSummaryLLM));
+LLM_DEFINE_TAG(IotaTile_Doors, NAME_None, TEXT("IotaTile"), GET_STATFNAME(STAT_IotaTile_DoorsLLM), GET_STATFNAME(STAT_IotaTileSummaryLLM));
+LLM_DEFINE_TAG(IotaTile_Streams, NAME_None, TEXT("IotaTile"), GET_STATFNAME(STAT_IotaTile_StreamsLLM), GET_STATFNAME(STAT_IotaTileSummaryLLM));
+LLM_DEFINE_TAG(IotaTile_Assets, NAME_None, TEXT("IotaTile"), GET_STATFNAME(STAT_IotaTile_AssetsLLM), GET_STATFNAME(STAT_IotaTileSummaryLLM));
@@ -0,0 +1,56 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "HAL/LowLevelMemStats.h"
+
+/**
+ * Unreal Insights channel covering the tile pipeline, from the generator asset query through to
+ * door spawning. Enable it alongside the CPU channel with "-trace=cpu,IotaTile".
+ */
+UE_TRACE_CHANNEL_EXTERN(IotaTileChannel);
+
+/** Opens a timing scope with a static name on the tile trace channel. */
+#define TILE_TRACE_SCOPE(Name) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(Name, IotaTileChannel)
+
+/**
+ * Opens a timing scope on the tile trace channel whose name carries formatted metadata, such as
+ * map or tile indices. The name is only formatted while the channel is enabled.
+ */
+#define TILE_TRACE_SCOPE_TEXT(Format, ...) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(UE_TRACE_CHANNELEXPR_IS_ENABLED(IotaTileChannel) ? *FString::Printf(Format, ##__VA_ARGS__) : TEXT(""), IotaTileChannel)
+
+/**
+ * Low Level Memory Tracker tags for the tile system. Each tag groups the allocations made by one
+ * part of the pipeline so that "stat llmfull" and memreport show what the tile system holds. The
+ * part tags are children of the IotaTile tag, which "stat llm" reports as their total.
+ */
+LLM_DECLARE_TAG(IotaTile);
+
+DECLARE_LLM_MEMORY_STAT(TEXT("IotaTile"), STAT_IotaTileLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("IotaTile"), STAT_IotaTileSummaryLLM, STATGROUP_LLM);
+DECLARE_LLM_MEMORY_STAT(TEXT("IotaTile_Generator"), STAT_IotaTile_GeneratorLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("IotaTile_Graph"), STAT_IotaTile_GraphLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("IotaTile_Doors"), STAT_IotaTile_DoorsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("IotaTile_Streams"), STAT_IotaTile_StreamsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("IotaTile_Assets"), STAT_IotaTile_AssetsLLM, STATGROUP_LLMFULL);
+
+/** Generator palettes, scheme sequences, and in-progress tile plans. */
+LLM_DECLARE_TAG(IotaTile_Generator);
+
+/** Tile map graph nodes and edges. */
+LLM_DECLARE_TAG(IotaTile_Graph);
+
+/** Door spawn requests and door actors. */
+LLM_DECLARE_TAG(IotaTile_Doors);
+
+/** Tile level stream instances. */
+LLM_DECLARE_TAG(IotaTile_Streams);
+
+/** Tile data assets loaded for the generator. */
+LLM_DECLARE_TAG(IotaTile_Assets);
@@ -0,0 +1,113 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#include "TileMap/TilePortalVisibility.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace TilePortalVisibilityTest
+{
+	/** Door sized portal used by every test, four meters wide and three meters tall. */
+	const FIntPoint PortalSize(4, 3);
+
+	/**
+	 * Checks the visible set of every tile against the expected rows, where each row lists the
+	 * visibility of every tile from one viewer tile.
+	 */
+	void TestVisibleSets(FAutomationTestBase& Test, const FTilePortalVisibility& Visibility, const TArray<TArray<bool>>& Expected)
+	{
+		Test.TestEqual(TEXT("Tile count"), Visibility.GetNumTiles(), Expected.Num());
+
+		for (int32 FromTile = 0; FromTile < Expected.Num(); FromTile++)
+		{
+			for (int32 ToTile = 0; ToTile < Expected[FromTile].Num(); ToTile++)
+			{
+				Test.TestEqual(FString::Printf(TEXT("Tile %i visible from tile %i"), ToTile, FromTile), Visibility.IsVisible(FromTile, ToTile), Expected[FromTile][ToTile]);
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTilePortalVisibilityCorridorTest, "Iota.Tile.PortalVisibility.Corridor", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FTilePortalVisibilityCorridorTest::RunTest(const FString& Parameters)
+{
+	using namespace TilePortalVisibilityTest;
+
+	// Five tiles in a straight line along X, joined by aligned portals. Every tile can see down
+	// the whole corridor.
+	FTilePortalVisibility Visibility;
+	Visibility.Reset(5);
+
+	for (int32 Tile = 0; Tile < 4; Tile++)
+	{
+		Visibility.AddPortal(Tile, Tile + 1, FTilePortal(FVector(1000 * Tile + 500, 0, 0), FVector::ForwardVector, PortalSize));
+	}
+
+	Visibility.Compute();
+
+	TArray<TArray<bool>> Expected;
+	Expected.Init({ true, true, true, true, true }, 5);
+
+	TestVisibleSets(*this, Visibility, Expected);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTilePortalVisibilityBendTest, "Iota.Tile.PortalVisibility.Bend", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FTilePortalVisibilityBendTest::RunTest(const FString& Parameters)
+{
+	using namespace TilePortalVisibilityTest;
+
+	// A tile along X opens into a corner tile, which turns along Y into a long corridor tile and
+	// then a far tile. The far tile lies around the bend from the first tile, and the reverse.
+	FTilePortalVisibility Visibility;
+	Visibility.Reset(4);
+
+	Visibility.AddPortal(0, 1, FTilePortal(FVector(500, 0, 0), FVector::ForwardVector, PortalSize));
+	Visibility.AddPortal(1, 2, FTilePortal(FVector(1000, 500, 0), FVector::RightVector, PortalSize));
+	Visibility.AddPortal(2, 3, FTilePortal(FVector(1000, 2500, 0), FVector::RightVector, PortalSize));
+
+	Visibility.Compute();
+
+	TestVisibleSets(*this, Visibility, {
+		{ true, true, true, false },
+		{ true, true, true, true },
+		{ true, true, true, true },
+		{ false, true, true, true }
+	});
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTilePortalVisibilityBranchTest, "Iota.Tile.PortalVisibility.Branch", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FTilePortalVisibilityBranchTest::RunTest(const FString& Parameters)
+{
+	using namespace TilePortalVisibilityTest;
+
+	// A hub tile joins a straight corridor along X to a side branch along Y, which continues
+	// into a far tile. The far tile is only visible from the branch, and neither end of the
+	// straight corridor can see it.
+	FTilePortalVisibility Visibility;
+	Visibility.Reset(5);
+
+	Visibility.AddPortal(0, 1, FTilePortal(FVector(500, 0, 0), FVector::ForwardVector, PortalSize));
+	Visibility.AddPortal(1, 2, FTilePortal(FVector(1500, 0, 0), FVector::ForwardVector, PortalSize));
+	Visibility.AddPortal(1, 3, FTilePortal(FVector(1000, 500, 0), FVector::RightVector, PortalSize));
+	Visibility.AddPortal(3, 4, FTilePortal(FVector(1000, 2500, 0), FVector::RightVector, PortalSize));
+
+	Visibility.Compute();
+
+	TestVisibleSets(*this, Visibility, {
+		{ true, true, true, true, false },
+		{ true, true, true, true, true },
+		{ true, true, true, true, false },
+		{ true, true, true, true, true },
+		{ false, true, false, true, true }
+	});
+
+	return true;
+}
+
+#endif
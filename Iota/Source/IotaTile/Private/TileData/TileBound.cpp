@@ -28,6 +28,13 @@ FTileBound::FTileBound(const FTileBound& TileBound, const FTransform& Transform)
 	// Copy constructor.
 }
 
+bool FTileBound::Contains(const FVector& Point) const
+{
+	// Move the point into the box frame, where the test reduces to an extent comparison.
+	FVector Local = Rotation.UnrotateVector(Point - Center).GetAbs();
+	return Local.X <= Extent.X && Local.Y <= Extent.Y && Local.Z <= Extent.Z;
+}
+
 bool FTileBound::CheckCollision(const FTileBound& A, const FTileBound& B)
 {
 	// Perform a bounding sphere check.
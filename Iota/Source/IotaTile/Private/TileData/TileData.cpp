@@ -9,16 +9,18 @@ FTileData::FTileData()
 	// Default constructor.
 }
 
-FTileData::FTileData(const TSoftObjectPtr<UWorld>& InLevel, const TArray<FTilePortal>& InPortals, const TArray<FTileBound>& InBounds)
+FTileData::FTileData(const TSoftObjectPtr<UWorld>& InLevel, const TArray<FTilePortal>& InPortals, const TArray<FTileBound>& InBounds, const TArray<float>& InPortalDistances)
 	: Level(InLevel)
 	, Portals(InPortals)
 	, Bounds(InBounds)
+	, PortalDistances(InPortalDistances)
 {
 	// Complete constructor.
 }
 
 FTileData::FTileData(const FTileData& TileData, const FTransform& Transform)
 	: Level(TileData.Level)
+	, PortalDistances(TileData.PortalDistances)
 {
 	for (const FTilePortal& Portal : TileData.Portals)
 	{
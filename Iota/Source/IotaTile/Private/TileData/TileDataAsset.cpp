@@ -1,10 +1,20 @@
 // Copyright Sydney Fonderie, 2023. All Rights Reserved.
 
 #include "TileData/TileDataAsset.h"
+#include "IotaTileStats.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(TileDataAsset)
 
 FTileData UTileDataAsset::GetTileData() const
 {
-	return FTileData(Level, Portals, Bounds);
+	return FTileData(Level, Portals, Bounds, PortalDistances);
+}
+
+void UTileDataAsset::Serialize(FArchive& Archive)
+{
+	// Portal and bound arrays are allocated during serialization, so tagging here attributes the
+	// loaded tile data to the tile system regardless of which thread performs the load.
+	LLM_SCOPE_BYTAG(IotaTile_Assets);
+
+	Super::Serialize(Archive);
 }
@@ -3,12 +3,17 @@
 #include "TileData/TileDataExport.h"
 #include "Components/SceneComponent.h"
 #include "Components/BillboardComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/Level.h"
 #include "UObject/ConstructorHelpers.h"
 #include "UObject/ObjectSaveContext.h"
 #include "UObject/SavePackage.h"
 #include "UObject/Package.h"
 #include "Engine/Texture2D.h"
 #include "AssetRegistry/AssetRegistryModule.h"
+#include "NavigationSystem.h"
+#include "NavigationPath.h"
+#include "IotaTileLog.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(TileDataExport)
 
@@ -57,12 +62,99 @@ ATileDataExport::ATileDataExport()
 #endif
 }
 
+void ATileDataExport::MarkCosmeticPrimitives()
+{
+	ULevel* Level = GetLevel();
+
+	if (!Level)
+	{
+		return;
+	}
+
+	int32 CosmeticCount = 0;
+	int32 PrimitiveCount = 0;
+
+	for (AActor* Actor : Level->Actors)
+	{
+		// Export actors carry tile data rather than level content, so leave them as they are.
+		if (!IsValid(Actor) || Actor->IsA<ATileDataExport>() || Actor->IsA<ATilePortalActor>() || Actor->IsA<ATileBoundActor>())
+		{
+			continue;
+		}
+
+		TInlineComponentArray<UPrimitiveComponent*> Primitives(Actor);
+
+		for (UPrimitiveComponent* Primitive : Primitives)
+		{
+			// Only static primitives qualify, since gameplay code may still reference movable ones.
+			bool bCosmetic = bStripCosmeticsOnServer
+				&& !Actor->GetIsReplicated()
+				&& Primitive->Mobility == EComponentMobility::Static
+				&& Primitive->GetCollisionEnabled() == ECollisionEnabled::NoCollision
+				&& !Primitive->CanEverAffectNavigation();
+
+			if (Primitive->AlwaysLoadOnServer == bCosmetic)
+			{
+				Primitive->Modify();
+				Primitive->AlwaysLoadOnServer = !bCosmetic;
+			}
+
+			CosmeticCount += bCosmetic;
+			PrimitiveCount++;
+		}
+	}
+
+	UE_LOG(LogIotaTile, Log, TEXT("%s: %i of %i primitives excluded from dedicated servers."), *GetWorld()->GetMapName(), CosmeticCount, PrimitiveCount);
+}
+
+void ATileDataExport::ExportPortalDistances(UTileDataAsset* DataAssetObject) const
+{
+	// Portal locations sit on the tile boundary, which navigation meshes rarely reach, so paths
+	// are measured between points just inside each portal and the inset is added back afterwards.
+	static constexpr FVector::FReal PortalInset = 50.0;
+
+	const TArray<FTilePortal>& Portals = DataAssetObject->Portals;
+	const int32 NumPortals = Portals.Num();
+
+	DataAssetObject->PortalDistances.SetNumZeroed(NumPortals * NumPortals);
+
+	int32 NavigatedCount = 0;
+
+	for (int32 From = 0; From < NumPortals; From++)
+	{
+		for (int32 To = From + 1; To < NumPortals; To++)
+		{
+			FVector Start = Portals[From].Location - Portals[From].Direction.GetSafeNormal() * PortalInset;
+			FVector End = Portals[To].Location - Portals[To].Direction.GetSafeNormal() * PortalInset;
+
+			float Distance = static_cast<float>(FVector::Distance(Portals[From].Location, Portals[To].Location));
+			UNavigationPath* Path = UNavigationSystemV1::FindPathToLocationSynchronously(GetWorld(), Start, End);
+
+			// Partial paths end short of the goal, so only complete paths replace the fallback.
+			if (Path && Path->IsValid() && !Path->IsPartial())
+			{
+				Distance = FMath::Max(Distance, static_cast<float>(Path->GetPathLength() + PortalInset * 2));
+				NavigatedCount++;
+			}
+
+			DataAssetObject->PortalDistances[From * NumPortals + To] = Distance;
+			DataAssetObject->PortalDistances[To * NumPortals + From] = Distance;
+		}
+	}
+
+	UE_LOG(LogIotaTile, Log, TEXT("%s: %i of %i portal distances measured on the navigation mesh."), *GetWorld()->GetMapName(), NavigatedCount, NumPortals * (NumPortals - 1) / 2);
+}
+
 void ATileDataExport::PreSave(FObjectPreSaveContext ObjectSaveContext)
 {
 	Super::PreSave(ObjectSaveContext);
 
 	if (GIsEditor && GetWorld() && !GetWorld()->HasBegunPlay())
 	{
+		// Every object in the package runs PreSave before any of them are serialized, so flags set
+		// on other actors here are still saved with the level.
+		MarkCosmeticPrimitives();
+
 		if (DataAsset.IsNull() && bAutoCreateAsset)
 		{
 			// Isolate the tileset tag name.
@@ -105,6 +197,8 @@ void ATileDataExport::PreSave(FObjectPreSaveContext ObjectSaveContext)
 				DataAssetObject->Bounds.Emplace(TileBoundActor->GetTileBound());
 			}
 
+			ExportPortalDistances(DataAssetObject);
+
 			if (UPackage* AssetPackage = DataAssetObject->GetPackage())
 			{
 				// Mark the package for saving.
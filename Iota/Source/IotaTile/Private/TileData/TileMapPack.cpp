@@ -0,0 +1,255 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#include "TileData/TileMapPack.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(TileMapPack)
+
+namespace TileMapPack
+{
+	/** Largest level table accepted when reading a pack. */
+	constexpr uint32 MaxLevels = 4096;
+
+	/** Largest plan count accepted when reading a pack. */
+	constexpr uint32 MaxPlans = 65536;
+
+	/** Maximum distance, in world units, between a plan location and its grid point. */
+	constexpr double LocationTolerance = 0.01;
+
+	/** Maximum difference, in degrees, between a plan rotation and its quarter turn. */
+	constexpr double RotationTolerance = 0.01;
+
+	/** Maps signed values onto unsigned values so that small magnitudes pack into few bytes. */
+	uint32 ZigZagEncode(int32 Value)
+	{
+		return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+	}
+
+	/** Reverses ZigZagEncode. */
+	int32 ZigZagDecode(uint32 Value)
+	{
+		return static_cast<int32>(Value >> 1) ^ -static_cast<int32>(Value & 1);
+	}
+}
+
+FTileMapPack::FTileMapPack()
+	: Origin(0, 0, 0)
+{
+	// Default constructor.
+}
+
+bool FTileMapPack::NetSerialize(FArchive& Archive, UPackageMap* PackageMap, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	// Header values are sent at full precision once per map.
+	Origin.NetSerialize(Archive, PackageMap, bOutSuccess);
+	Archive << OriginYaw;
+	Archive << GridSize;
+
+	uint32 PackedIndex = MapIndex;
+	Archive.SerializeIntPacked(PackedIndex);
+	MapIndex = PackedIndex;
+
+	if (Archive.IsSaving())
+	{
+		// Build the level table. Each unique level path is written once, in order of first use.
+		TArray<FString> LevelTable;
+		TMap<FString, uint32> LevelIndices;
+		TArray<uint32> PlanLevels;
+		PlanLevels.Reserve(Plans.Num());
+
+		for (const FTilePlan& TilePlan : Plans)
+		{
+			FString AssetPath = TilePlan.Level.ToString();
+
+			if (const uint32* LevelIndex = LevelIndices.Find(AssetPath))
+			{
+				PlanLevels.Add(*LevelIndex);
+			}
+			else
+			{
+				PlanLevels.Add(LevelIndices.Add(AssetPath, LevelTable.Num()));
+				LevelTable.Emplace(MoveTemp(AssetPath));
+			}
+		}
+
+		uint32 LevelCount = LevelTable.Num();
+		Archive.SerializeIntPacked(LevelCount);
+
+		for (FString& AssetPath : LevelTable)
+		{
+			Archive << AssetPath;
+		}
+
+		uint32 PlanCount = Plans.Num();
+		Archive.SerializeIntPacked(PlanCount);
+
+		for (int32 Index = 0; Index < Plans.Num(); Index++)
+		{
+			FTilePlan& TilePlan = Plans[Index];
+			Archive.SerializeIntPacked(PlanLevels[Index]);
+
+			uint32 PackedParent = FMath::Max(TilePlan.Parent + 1, 0);
+			Archive.SerializeIntPacked(PackedParent);
+
+			FIntVector Cell;
+			uint8 Quarter = 0;
+			uint8 bQuantized = Quantize(TilePlan, Cell, Quarter);
+			Archive.SerializeBits(&bQuantized, 1);
+
+			if (bQuantized)
+			{
+				uint32 X = TileMapPack::ZigZagEncode(Cell.X);
+				uint32 Y = TileMapPack::ZigZagEncode(Cell.Y);
+				uint32 Z = TileMapPack::ZigZagEncode(Cell.Z);
+
+				Archive.SerializeIntPacked(X);
+				Archive.SerializeIntPacked(Y);
+				Archive.SerializeIntPacked(Z);
+				Archive.SerializeBits(&Quarter, 2);
+			}
+			else
+			{
+				// Off-grid plans use the full-precision tile plan format.
+				TilePlan.Location.NetSerialize(Archive, PackageMap, bOutSuccess);
+				TilePlan.Rotation.NetSerialize(Archive, PackageMap, bOutSuccess);
+			}
+		}
+	}
+	else
+	{
+		Plans.Reset();
+
+		// Reject header values that would make the grid meaningless.
+		if (!FMath::IsFinite(GridSize) || GridSize <= 0 || !FMath::IsFinite(OriginYaw))
+		{
+			Archive.SetError();
+		}
+
+		uint32 LevelCount = 0;
+		Archive.SerializeIntPacked(LevelCount);
+
+		// Check each count before allocating so that corrupt data cannot request huge arrays.
+		if (TileMapPack::MaxLevels < LevelCount)
+		{
+			Archive.SetError();
+		}
+
+		TArray<FString> LevelTable;
+
+		for (uint32 Index = 0; Index < LevelCount && !Archive.IsError(); Index++)
+		{
+			Archive << LevelTable.Emplace_GetRef();
+		}
+
+		uint32 PlanCount = 0;
+		Archive.SerializeIntPacked(PlanCount);
+
+		if (TileMapPack::MaxPlans < PlanCount)
+		{
+			Archive.SetError();
+		}
+
+		for (uint32 Index = 0; Index < PlanCount && !Archive.IsError(); Index++)
+		{
+			FTilePlan& TilePlan = Plans.Emplace_GetRef();
+
+			uint32 LevelIndex = 0;
+			Archive.SerializeIntPacked(LevelIndex);
+
+			if (static_cast<uint32>(LevelTable.Num()) <= LevelIndex)
+			{
+				Archive.SetError();
+				break;
+			}
+
+			TilePlan.Level = LevelTable[LevelIndex];
+
+			// Parents always precede their children in a tile map.
+			uint32 PackedParent = 0;
+			Archive.SerializeIntPacked(PackedParent);
+
+			if (Index < PackedParent)
+			{
+				Archive.SetError();
+				break;
+			}
+
+			TilePlan.Parent = static_cast<int32>(PackedParent) - 1;
+
+			uint8 bQuantized = 0;
+			Archive.SerializeBits(&bQuantized, 1);
+
+			if (bQuantized)
+			{
+				uint32 X = 0;
+				uint32 Y = 0;
+				uint32 Z = 0;
+				uint8 Quarter = 0;
+
+				Archive.SerializeIntPacked(X);
+				Archive.SerializeIntPacked(Y);
+				Archive.SerializeIntPacked(Z);
+				Archive.SerializeBits(&Quarter, 2);
+
+				FIntVector Cell(TileMapPack::ZigZagDecode(X), TileMapPack::ZigZagDecode(Y), TileMapPack::ZigZagDecode(Z));
+				Dequantize(TilePlan, Cell, Quarter);
+			}
+			else
+			{
+				TilePlan.Location.NetSerialize(Archive, PackageMap, bOutSuccess);
+				TilePlan.Rotation.NetSerialize(Archive, PackageMap, bOutSuccess);
+			}
+		}
+
+		// Never hand out a partial map.
+		if (Archive.IsError())
+		{
+			Plans.Empty();
+			MapIndex = 0;
+		}
+	}
+
+	bOutSuccess = bOutSuccess && !Archive.IsError();
+	return true;
+}
+
+bool FTileMapPack::Quantize(const FTilePlan& TilePlan, FIntVector& OutCell, uint8& OutQuarter) const
+{
+	// Only yaw rotations can be quantized.
+	if (TileMapPack::RotationTolerance < FMath::Abs(TilePlan.Rotation.Pitch) || TileMapPack::RotationTolerance < FMath::Abs(TilePlan.Rotation.Roll))
+	{
+		return false;
+	}
+
+	// The yaw must be a whole number of quarter turns from the map yaw.
+	double Yaw = FRotator::NormalizeAxis(TilePlan.Rotation.Yaw - OriginYaw);
+	double Quarters = FMath::RoundToDouble(Yaw / 90);
+
+	if (TileMapPack::RotationTolerance < FMath::Abs(Yaw - Quarters * 90))
+	{
+		return false;
+	}
+
+	// The location must sit on a grid point in map space.
+	FVector Local = FRotator(0, OriginYaw, 0).UnrotateVector(TilePlan.Location - Origin) / GridSize;
+	FVector Rounded = Local.GridSnap(1);
+
+	if (TileMapPack::LocationTolerance < FVector::Dist(Local, Rounded) * GridSize || MAX_int32 / 2 < Rounded.GetAbsMax())
+	{
+		return false;
+	}
+
+	OutCell = FIntVector(FMath::RoundToInt(Rounded.X), FMath::RoundToInt(Rounded.Y), FMath::RoundToInt(Rounded.Z));
+	OutQuarter = static_cast<uint8>((static_cast<int32>(Quarters) + 4) % 4);
+
+	return true;
+}
+
+void FTileMapPack::Dequantize(FTilePlan& TilePlan, const FIntVector& Cell, uint8 Quarter) const
+{
+	FRotator MapRotation(0, OriginYaw, 0);
+
+	TilePlan.Location = Origin + MapRotation.RotateVector(FVector(Cell) * GridSize);
+	TilePlan.Rotation = FRotator(0, FRotator::NormalizeAxis(OriginYaw + Quarter * 90), 0);
+}
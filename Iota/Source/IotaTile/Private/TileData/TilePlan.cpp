@@ -23,6 +23,7 @@ FTilePlan::FTilePlan(const FTilePlan& TilePlan)
 	: Level(TilePlan.Level)
 	, Location(TilePlan.Location)
 	, Rotation(TilePlan.Rotation)
+	, Parent(TilePlan.Parent)
 {
 	// Copy constructor.
 }
@@ -36,6 +37,27 @@ bool FTilePlan::NetSerialize(FArchive& Archive, UPackageMap* PackageMap, bool& b
 	Location.NetSerialize(Archive, PackageMap, bOutSuccess);
 	Rotation.NetSerialize(Archive, PackageMap, bOutSuccess);
 
+	// Offset the parent index so that the root (and other negative values) pack into one byte.
+	uint32 PackedParent = FMath::Max(Parent + 1, 0);
+	Archive.SerializeIntPacked(PackedParent);
+	Parent = static_cast<int32>(PackedParent) - 1;
+
 	bOutSuccess = true;
 	return true;
 }
+
+uint32 GetTypeHash(const FTilePlan& TilePlan)
+{
+	// Round the transform values before hashing to absorb floating point noise.
+	const int64 Values[] = {
+		FMath::RoundToInt64(TilePlan.Location.X * 10),
+		FMath::RoundToInt64(TilePlan.Location.Y * 10),
+		FMath::RoundToInt64(TilePlan.Location.Z * 10),
+		FMath::RoundToInt64(TilePlan.Rotation.Pitch * 10),
+		FMath::RoundToInt64(TilePlan.Rotation.Yaw * 10),
+		FMath::RoundToInt64(TilePlan.Rotation.Roll * 10),
+	};
+
+	uint32 Hash = FCrc::StrCrc32(*TilePlan.Level.ToString());
+	return FCrc::MemCrc32(Values, sizeof(Values), Hash);
+}
@@ -6,11 +6,17 @@
 #include "TileData/TileDataAsset.h"
 #include "TileData/TilePlan.h"
 #include "Engine/AssetManager.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "IotaTileStats.h"
 
-FTileGenAction::FTileGenAction(const FTileGenParams& InParams, const FSimpleDelegate& InDelegate)
+FTileGenAction::FTileGenAction(const FTileGenParams& InParams, const FSimpleDelegate& InDelegate, int32 InBudgetCutoff)
 	: Params(InParams)
 	, OnComplete(InDelegate)
+	, BudgetCutoff(InBudgetCutoff)
 {
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileGenAction::QueryAssets [%s]"), *Params.Tileset.ToString());
+	LLM_SCOPE_BYTAG(IotaTile_Assets);
+
 	UAssetManager& AssetManager = UAssetManager::Get();
 
 	// Load all asset data matching the tile data asset type into a list.
@@ -52,7 +58,14 @@ FTileGenAction::FTileGenAction(const FTileGenParams& InParams, const FSimpleDele
 	// Asset Manager will keep the assets loaded until they are manually released, so the action
 	// will need to unload them prior to destruction.
 	FStreamableDelegate Callback = FStreamableDelegate::CreateRaw(this, &FTileGenAction::NotifyAssetsLoaded);
-	ActionAssetHandle = AssetManager.LoadPrimaryAssets(ActionAssetList, TArray<FName>(), Callback);
+
+	{
+		TILE_TRACE_SCOPE_TEXT(TEXT("TileGenAction::LoadPrimaryAssets [Assets=%i]"), ActionAssetList.Num());
+		ActionAssetHandle = AssetManager.LoadPrimaryAssets(ActionAssetList, TArray<FName>(), Callback);
+	}
+
+	// The load itself completes asynchronously, so bookmark the request to show the wait.
+	TRACE_BOOKMARK(TEXT("IotaTile: Assets Requested (%i)"), ActionAssetList.Num());
 }
 
 FTileGenAction::~FTileGenAction()
@@ -67,6 +80,10 @@ FTileGenAction::~FTileGenAction()
 		ActionAssetHandle->CancelHandle();
 	}
 
+	// Release any prefetched levels.
+	ReleasePrefetch();
+	ReleasePlacedLevels();
+
 	// Attempt to release all requested assets so that their memory can be reclaimed.
 	// Do this regardless of load state since assets might be partially loaded.
 	UAssetManager::Get().UnloadPrimaryAssets(ActionAssetList);
@@ -74,6 +91,10 @@ FTileGenAction::~FTileGenAction()
 
 void FTileGenAction::NotifyAssetsLoaded()
 {
+	TRACE_BOOKMARK(TEXT("IotaTile: Assets Loaded (%i)"), ActionAssetList.Num());
+	TILE_TRACE_SCOPE("TileGenAction::NotifyAssetsLoaded");
+	LLM_SCOPE_BYTAG(IotaTile_Generator);
+
 	UAssetManager& AssetManager = UAssetManager::Get();
 
 	// Create an array of loaded tile data assets.
@@ -85,13 +106,47 @@ void FTileGenAction::NotifyAssetsLoaded()
 	{
 		if (AssetID.PrimaryAssetType == UTileDataAsset::StaticClass()->GetFName())
 		{
-			TileDataAssets.Emplace(AssetManager.GetPrimaryAssetObject<UTileDataAsset>(AssetID));
+			if (UTileDataAsset* TileDataAsset = AssetManager.GetPrimaryAssetObject<UTileDataAsset>(AssetID))
+			{
+				TileDataAssets.Emplace(TileDataAsset);
+			}
+		}
+	}
+
+	// The Asset Manager does not guarantee the order of the asset list, but the generator consumes
+	// its palettes in order. Sort the assets by path so that every machine generating from the
+	// same seed builds the same palettes.
+	TileDataAssets.Sort([](const UTileDataAsset& A, const UTileDataAsset& B)
+	{
+		return A.GetPathName() < B.GetPathName();
+	});
+
+	// Request every tile level in the tileset below default priority so that disk I/O overlaps
+	// with generation without delaying any other load. Levels are requested through the
+	// streamable manager, whose handle keeps the loaded packages (and their dependencies) from
+	// being garbage collected before streaming.
+	if (Params.bPrefetchLevels)
+	{
+		TArray<FSoftObjectPath> LevelPaths;
+
+		for (const UTileDataAsset* TileDataAsset : TileDataAssets)
+		{
+			if (!TileDataAsset->Level.IsNull())
+			{
+				LevelPaths.AddUnique(TileDataAsset->Level.ToSoftObjectPath());
+			}
+		}
+
+		if (!LevelPaths.IsEmpty())
+		{
+			TILE_TRACE_SCOPE_TEXT(TEXT("TileGenAction::PrefetchLevels [Levels=%i]"), LevelPaths.Num());
+			LevelPrefetchHandle = AssetManager.GetStreamableManager().RequestAsyncLoad(LevelPaths, FStreamableDelegate(), FStreamableManager::DefaultAsyncLoadPriority - 1);
 		}
 	}
 
 	// Create the generation worker, which handles the rest of the process.
 	// Doing so also starts the worker, so the action is done running for now.
-	AsyncWorker = MakeShared<FTileGenWorker>(Params, TileDataAssets, OnComplete);
+	AsyncWorker = MakeShared<FTileGenWorker>(Params, TileDataAssets, OnComplete, BudgetCutoff);
 
 	// Clear the handle so that the destructor knows the action is safe.
 	ActionAssetHandle.Reset();
@@ -99,7 +154,8 @@ void FTileGenAction::NotifyAssetsLoaded()
 
 void FTileGenAction::Regenerate()
 {
-	if (CanAccess())
+	// Infeasible tilesets never start a thread, so there is nothing to regenerate.
+	if (CanAccess() && !AsyncWorker->Report.IsInfeasible())
 	{
 		AsyncWorker->Start();
 	}
@@ -112,10 +168,146 @@ bool FTileGenAction::CanAccess() const
 
 bool FTileGenAction::IsMapValid() const
 {
-	return CanAccess() && Params.Length <= AsyncWorker->TileMap.Num();
+	return GetQuality() != ETileGenQuality::None;
+}
+
+ETileGenQuality FTileGenAction::GetQuality() const
+{
+	return CanAccess() ? AsyncWorker->Quality : ETileGenQuality::None;
+}
+
+int32 FTileGenAction::GetCoreLength() const
+{
+	return CanAccess() ? AsyncWorker->CoreLength : 0;
 }
 
 const TArray<FTileGraphPlan>* FTileGenAction::GetTileMap() const
 {
 	return CanAccess() ? &AsyncWorker->TileMap : nullptr;
 }
+
+FTileGenReport FTileGenAction::GetReport() const
+{
+	return CanAccess() ? AsyncWorker->Report : FTileGenReport();
+}
+
+uint32 FTileGenAction::GetTilesetHash() const
+{
+	return AsyncWorker.IsValid() ? AsyncWorker->TilesetHash : 0;
+}
+
+uint32 FTileGenAction::GetMapHash() const
+{
+	uint32 Hash = 0;
+
+	if (CanAccess())
+	{
+		for (const FTileGraphPlan& GraphPlan : AsyncWorker->TileMap)
+		{
+			Hash = HashCombine(Hash, GetTypeHash(static_cast<const FTilePlan&>(GraphPlan)));
+		}
+	}
+
+	return Hash;
+}
+
+int32 FTileGenAction::GetBudgetCutoff() const
+{
+	return CanAccess() ? FMath::Max(AsyncWorker->BudgetCutoff, 0) : 0;
+}
+
+void FTileGenAction::PrioritizeLevels()
+{
+	if (!LevelPrefetchHandle.IsValid() || !CanAccess())
+	{
+		return;
+	}
+
+	TSet<FSoftObjectPath> LevelPaths;
+
+	for (const FTileGraphPlan& GraphPlan : AsyncWorker->TileMap)
+	{
+		if (!GraphPlan.Level.IsNull())
+		{
+			LevelPaths.Add(GraphPlan.Level.ToSoftObjectPath());
+		}
+	}
+
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileGenAction::PrioritizeLevels [Levels=%i]"), LevelPaths.Num());
+
+	// Levels committed by discarded attempts fall back to prefetch priority.
+	for (auto It = LevelPriorityHandles.CreateIterator(); It; ++It)
+	{
+		if (!LevelPaths.Contains(It.Key()))
+		{
+			if (It.Value().IsValid())
+			{
+				It.Value()->ReleaseHandle();
+			}
+
+			It.RemoveCurrent();
+		}
+	}
+
+	for (const FTileGraphPlan& GraphPlan : AsyncWorker->TileMap)
+	{
+		PrioritizeLevel(GraphPlan.Level);
+	}
+}
+
+void FTileGenAction::ReleasePrefetch()
+{
+	// The handles have no callbacks, so they are safe to release whether or not the loads have
+	// finished.
+	if (LevelPrefetchHandle.IsValid())
+	{
+		LevelPrefetchHandle->ReleaseHandle();
+		LevelPrefetchHandle.Reset();
+	}
+}
+
+void FTileGenAction::ReleasePlacedLevels()
+{
+	if (LevelPrefetchHandle.IsValid())
+	{
+		return;
+	}
+
+	for (const TPair<FSoftObjectPath, TSharedPtr<FStreamableHandle>>& Pair : LevelPriorityHandles)
+	{
+		if (Pair.Value.IsValid())
+		{
+			Pair.Value->ReleaseHandle();
+		}
+	}
+
+	LevelPriorityHandles.Empty();
+}
+
+bool FTileGenAction::DequeueCommit(FTileGenCommit& OutCommit)
+{
+	if (!AsyncWorker.IsValid() || !AsyncWorker->Commits.Dequeue(OutCommit))
+	{
+		return false;
+	}
+
+	// The level is about to stream, so load it ahead of the rest of the prefetched tileset.
+	PrioritizeLevel(OutCommit.Plan.Level);
+
+	return true;
+}
+
+void FTileGenAction::PrioritizeLevel(const TSoftObjectPtr<UWorld>& Level)
+{
+	if (!LevelPrefetchHandle.IsValid() || Level.IsNull() || LevelPriorityHandles.Contains(Level.ToSoftObjectPath()))
+	{
+		return;
+	}
+
+	LevelPriorityHandles.Add(Level.ToSoftObjectPath(), UAssetManager::GetStreamableManager().RequestAsyncLoad(Level.ToSoftObjectPath(), FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority));
+}
+
+int32 FTileGenAction::GetEpoch() const
+{
+	return CanAccess() ? AsyncWorker->Epoch : 0;
+}
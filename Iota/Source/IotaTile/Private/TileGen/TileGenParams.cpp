@@ -21,6 +21,12 @@ FTileGenParams::FTileGenParams(const FTileGenParams& Params)
 	, ObjectiveCount(Params.ObjectiveCount)
 	, Length(Params.Length)
 	, Branch(Params.Branch)
+	, bAdaptive(Params.bAdaptive)
+	, TimeBudget(Params.TimeBudget)
+	, PlacementBudget(Params.PlacementBudget)
+	, GridSize(Params.GridSize)
+	, bPrefetchLevels(Params.bPrefetchLevels)
+	, bPipelineStreaming(Params.bPipelineStreaming)
 	, Seed(Params.Seed)
 	, AssetActors(Params.AssetActors)
 {
@@ -0,0 +1,56 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#include "TileGen/TileGenReport.h"
+
+FString FTileGenReport::ToString() const
+{
+	if (!IsFailure())
+	{
+		return FString::Printf(TEXT("Attempt %i succeeded"), Attempt);
+	}
+
+	if (IsInfeasible())
+	{
+		return FString::Printf(TEXT("Tileset is infeasible: %s"), *Diagnostic);
+	}
+
+	const TCHAR* FailureName = TEXT("Unknown");
+
+	switch (Failure)
+	{
+	case ETileGenFailure::EmptyPalette:
+		FailureName = TEXT("EmptyPalette");
+		break;
+
+	case ETileGenFailure::NoOpenPortals:
+		FailureName = TEXT("NoOpenPortals");
+		break;
+
+	case ETileGenFailure::NoMatchingPortals:
+		FailureName = TEXT("NoMatchingPortals");
+		break;
+
+	case ETileGenFailure::Collisions:
+		FailureName = TEXT("Collisions");
+		break;
+
+	case ETileGenFailure::OverBudget:
+		FailureName = TEXT("OverBudget");
+		break;
+
+	default:
+		break;
+	}
+
+	return FString::Printf(
+		TEXT("Attempt %i failed at sequence index %i (%s): %s [Candidates=%i, OpenPortals=%i, Connections=%i, Collisions=%i]"),
+		Attempt,
+		SequenceIndex,
+		*StaticEnum<ETileScheme>()->GetNameStringByValue(*Scheme),
+		FailureName,
+		Candidates,
+		OpenPortals,
+		Connections,
+		Collisions
+	);
+}
@@ -5,14 +5,26 @@
 #include "TileData/TileDataAsset.h"
 #include "HAL/RunnableThread.h"
 #include "Async/Async.h"
+#include "IotaTileStats.h"
 
-FTileGenWorker::FTileGenWorker(const FTileGenParams& InParams, const TArray<UTileDataAsset*>& InTileList, const FSimpleDelegate& InDelegate)
+FTileGenWorker::FTileGenWorker(const FTileGenParams& InParams, const TArray<UTileDataAsset*>& InTileList, const FSimpleDelegate& InDelegate, int32 InBudgetCutoff)
 	: OnExit(InDelegate)
 	, Params(InParams)
 	, RandomStream(InParams.Seed)
+	, BudgetCutoff(InBudgetCutoff)
 {
+	LLM_SCOPE_BYTAG(IotaTile_Generator);
+
 	for (const UTileDataAsset* TileDataAsset : InTileList)
 	{
+		// Fold every generation-relevant value of the tile into the tileset hash. Machines that
+		// generate from the same seed must also agree on this hash to produce the same map.
+		TilesetHash = FCrc::StrCrc32(*TileDataAsset->Level.ToString(), TilesetHash);
+		TilesetHash = FCrc::StrCrc32(*TileDataAsset->Objectives.ToString(), TilesetHash);
+		TilesetHash = FCrc::MemCrc32(&TileDataAsset->Schemes, sizeof(int32), TilesetHash);
+		TilesetHash = FCrc::MemCrc32(TileDataAsset->Portals.GetData(), TileDataAsset->Portals.Num() * sizeof(FTilePortal), TilesetHash);
+		TilesetHash = FCrc::MemCrc32(TileDataAsset->Bounds.GetData(), TileDataAsset->Bounds.Num() * sizeof(FTileBound), TilesetHash);
+
 		bool bMainObjective = TileDataAsset->Objectives.HasTagExact(Params.MainObjective);
 		bool bSideObjective = TileDataAsset->Objectives.HasAnyExact(Params.SideObjectives);
 		bool bZeroObjective = TileDataAsset->Objectives.IsEmpty();
@@ -40,7 +52,28 @@ FTileGenWorker::FTileGenWorker(const FTileGenParams& InParams, const TArray<UTil
 		}
 	}
 
-	Start();
+	// Failure counts persist across regeneration attempts so that adaptive mode can use them.
+	FailureCounts.SetNumZeroed(Params.Length);
+
+	// The generation budget covers every attempt, so it starts with the worker.
+	BudgetStart = FPlatformTime::Seconds();
+
+	// Run the feasibility check before starting the thread. If the palettes cannot produce a valid
+	// tile map, skip generation entirely and report back so that the map is not regenerated.
+	FString Diagnostic;
+
+	if (CheckFeasibility(Diagnostic))
+	{
+		Start();
+	}
+	else
+	{
+		Report.Failure = ETileGenFailure::Infeasible;
+		Report.Diagnostic = Diagnostic;
+
+		bCanAccess = true;
+		Exit();
+	}
 }
 
 FTileGenWorker::~FTileGenWorker()
@@ -66,29 +99,182 @@ void FTileGenWorker::Start()
 	Thread = FRunnableThread::Create(this, TEXT("IotaTileGenThread"));
 }
 
+bool FTileGenWorker::CheckFeasibility(FString& OutDiagnostic) const
+{
+	TILE_TRACE_SCOPE("TileGenWorker::CheckFeasibility");
+
+	TArray<ETileScheme> CheckSequence;
+	Params.GetSchemeSequence(CheckSequence);
+
+	// Count how many tiles each scheme needs. Objective tiles are used at most once per map, so
+	// the objective palette must hold at least one tile for each objective in the sequence.
+	int32 Required[*ETileScheme::Count] = {};
+
+	for (ETileScheme Scheme : CheckSequence)
+	{
+		Required[*Scheme]++;
+	}
+
+	for (ETileScheme Scheme : TEnumRange<ETileScheme>())
+	{
+		int32 Available = TilePalettes[*Scheme].Num();
+		int32 Needed = IsObjective(Scheme) ? Required[*Scheme] : FMath::Min(Required[*Scheme], 1);
+
+		if (Available < Needed)
+		{
+			OutDiagnostic = FString::Printf(
+				TEXT("Tileset %s has %i %s tiles matching objective %s, but the sequence needs %i."),
+				*Params.Tileset.ToString(),
+				Available,
+				*StaticEnum<ETileScheme>()->GetNameStringByValue(*Scheme),
+				*Params.MainObjective.ToString(),
+				Needed
+			);
+
+			return false;
+		}
+	}
+
+	// Track every portal size that can appear on the map. This set is a superset of the sizes
+	// that are actually open at each step, so the connectivity check below never rejects a
+	// viable tileset, while the terminal check after it is deliberately stricter than needed.
+	TSet<FIntPoint> PortalSizes;
+
+	for (int32 Index = 0; Index < CheckSequence.Num(); Index++)
+	{
+		TSet<FIntPoint> NewSizes;
+		bool bConnectable = Index == 0;
+
+		for (const FTileData& TileData : TilePalettes[*CheckSequence[Index]])
+		{
+			bool bTileConnectable = Index == 0;
+
+			for (const FTilePortal& Portal : TileData.Portals)
+			{
+				bTileConnectable |= PortalSizes.Contains(Portal.PlaneSize);
+			}
+
+			// Only tiles that can actually attach contribute their portals to later steps.
+			if (bTileConnectable)
+			{
+				for (const FTilePortal& Portal : TileData.Portals)
+				{
+					NewSizes.Add(Portal.PlaneSize);
+				}
+			}
+
+			bConnectable |= bTileConnectable;
+		}
+
+		if (!bConnectable)
+		{
+			OutDiagnostic = FString::Printf(
+				TEXT("No %s tile in tileset %s shares a portal size with the tiles before sequence index %i."),
+				*StaticEnum<ETileScheme>()->GetNameStringByValue(*CheckSequence[Index]),
+				*Params.Tileset.ToString(),
+				Index
+			);
+
+			return false;
+		}
+
+		PortalSizes.Append(NewSizes);
+	}
+
+	// Every portal size that can appear needs a terminal tile, otherwise vacant portals of that
+	// size could never be sealed off with a terminal. Some of these sizes may never actually be
+	// left open, so this can reject a tileset the generator could have completed. The check is
+	// kept strict on purpose: a tileset that only works because of lucky placements fails at
+	// random seeds, which is far harder to diagnose than a missing terminal reported up front.
+	for (const FIntPoint& PortalSize : PortalSizes)
+	{
+		bool bCovered = false;
+
+		for (const FTileData& TileData : TilePalettes[*ETileScheme::Terminal])
+		{
+			for (const FTilePortal& Portal : TileData.Portals)
+			{
+				bCovered |= Portal.PlaneSize == PortalSize;
+			}
+		}
+
+		if (!bCovered)
+		{
+			OutDiagnostic = FString::Printf(
+				TEXT("Tileset %s has no Terminal tile for portal size %s."),
+				*Params.Tileset.ToString(),
+				*PortalSize.ToString()
+			);
+
+			return false;
+		}
+	}
+
+	return true;
+}
+
 bool FTileGenWorker::Init()
 {
+	LLM_SCOPE_BYTAG(IotaTile_Generator);
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileGenWorker::Init [Seed=%i, Length=%i]"), RandomStream.GetCurrentSeed(), Params.Length);
+
 	Params.GetSchemeSequence(Sequence);
 
 	TileMap.Empty(Params.Length);
 	Progress.Reset();
 
+	Quality = ETileGenQuality::None;
+	CoreLength = 0;
+
+	// Objective tiles are removed from their palette once placed, so return the tiles used by the
+	// previous attempt to keep every attempt working from the full palette.
+	TilePalettes[*ETileScheme::Objective].Append(UsedObjectives);
+	UsedObjectives.Empty();
+
+	// Every attempt builds a new tile map, so plans committed by the previous attempt are void.
+	Epoch++;
+
+	// Start a fresh report for the new attempt.
+	int32 Attempt = Report.Attempt + 1;
+	Report = FTileGenReport();
+	Report.Attempt = Attempt;
+
 	return true;
 }
 
 uint32 FTileGenWorker::Run()
 {
+	LLM_SCOPE_BYTAG(IotaTile_Generator);
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileGenWorker::Run [Seed=%i, Length=%i]"), RandomStream.GetCurrentSeed(), Params.Length);
+
 	// Core loop. Builds out the main level path using the tile sequence.
 	for (int32 Tile = 0; Tile < Params.Length && !bStopThread; Tile++)
 	{
 		if (!PlaceNewTile(Sequence[Tile]))
 		{
+			if (HandleCoreFailure())
+			{
+				break;
+			}
+
 			return 1;
 		}
 	}
 
+	if (bStopThread)
+	{
+		return 1;
+	}
+
+	// If the core loop ran to completion, the whole sequence was placed.
+	if (Quality == ETileGenQuality::None)
+	{
+		Quality = ETileGenQuality::Complete;
+		CoreLength = TileMap.Num();
+	}
+
 	// Second loop. Goes through each main tile and adds terminal seals.
-	for (int32 Tile = 0; Tile < Params.Length && !bStopThread; Tile++)
+	for (int32 Tile = 0; Tile < CoreLength && !bStopThread; Tile++)
 	{
 		PlaceTerminals(Tile);
 	}
@@ -98,19 +284,21 @@ uint32 FTileGenWorker::Run()
 
 void FTileGenWorker::Tick()
 {
+	LLM_SCOPE_BYTAG(IotaTile_Generator);
+
 	int32 Tile = Progress.GetValue();
 
 	// Core branch. Builds out the main level path using the tile sequence.
 	if (Tile < Params.Length && !bStopThread)
 	{
-		if (!PlaceNewTile(Sequence[Tile]))
+		if (!PlaceNewTile(Sequence[Tile]) && !HandleCoreFailure())
 		{
 			Thread->Kill();
 		}
 	}
 
 	// Second branch. Goes through each main tile and adds terminal seals.
-	else if (Tile < Params.Length * 2 && !bStopThread)
+	else if (Tile < Params.Length + CoreLength && !bStopThread)
 	{
 		PlaceTerminals(Tile - Params.Length);
 	}
@@ -120,6 +308,13 @@ void FTileGenWorker::Tick()
 	{
 		Thread->Kill();
 	}
+
+	// Once the core sequence is placed, record its length so that terminals can follow.
+	if (Progress.GetValue() == Params.Length && Quality == ETileGenQuality::None)
+	{
+		Quality = ETileGenQuality::Complete;
+		CoreLength = TileMap.Num();
+	}
 }
 
 void FTileGenWorker::Stop()
@@ -147,14 +342,39 @@ FSingleThreadRunnable* FTileGenWorker::GetSingleThreadInterface()
 bool FTileGenWorker::PlaceNewTile(ETileScheme Scheme)
 {
 	TArray<FTileData>& Palette = TilePalettes[*Scheme];
+
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileGenWorker::PlaceNewTile [Tile=%i, Scheme=%i, Candidates=%i]"), TileMap.Num(), *Scheme, Palette.Num());
+
+	// Core tiles are placed in sequence order, so the next sequence index is the map length.
+	int32 SequenceIndex = TileMap.Num();
+
 	ShuffleArray(Palette);
 
-	for (int32 Index = 0; Index < Palette.Num() && !bStopThread; Index++)
+	// In adaptive mode, a step that leads into a previously failing step prefers tiles with more
+	// portals so that the failing step has more places to attach. Stable sorting preserves the
+	// shuffled order between tiles with the same portal count.
+	if (Params.bAdaptive && FailureCounts.IsValidIndex(SequenceIndex + 1) && 0 < FailureCounts[SequenceIndex + 1])
+	{
+		Palette.StableSort([](const FTileData& A, const FTileData& B)
+		{
+			return A.Portals.Num() > B.Portals.Num();
+		});
+	}
+
+	FTileGenReport StepReport;
+	StepReport.Scheme = Scheme;
+	StepReport.SequenceIndex = SequenceIndex;
+	StepReport.Attempt = Report.Attempt;
+
+	for (int32 Index = 0; Index < Palette.Num() && !bStopThread && !CheckBudget(); Index++)
 	{
-		if (TryPlaceTile(Palette[Index]))
+		StepReport.Candidates++;
+
+		if (TryPlaceTile(Palette[Index], StepReport))
 		{
 			if (IsObjective(Scheme))
 			{
+				UsedObjectives.Emplace(Palette[Index]);
 				Palette.RemoveAtSwap(Index);
 			}
 
@@ -163,14 +383,47 @@ bool FTileGenWorker::PlaceNewTile(ETileScheme Scheme)
 		}
 	}
 
+	// Stopping the thread is not a generation failure, so only record failures from full searches.
+	if (!bStopThread)
+	{
+		if (IsOverBudget())
+		{
+			StepReport.Failure = ETileGenFailure::OverBudget;
+		}
+		else if (StepReport.Candidates == 0)
+		{
+			StepReport.Failure = ETileGenFailure::EmptyPalette;
+		}
+		else if (StepReport.OpenPortals == 0)
+		{
+			StepReport.Failure = ETileGenFailure::NoOpenPortals;
+		}
+		else if (StepReport.Connections == 0)
+		{
+			StepReport.Failure = ETileGenFailure::NoMatchingPortals;
+		}
+		else
+		{
+			StepReport.Failure = ETileGenFailure::Collisions;
+		}
+
+		Report = StepReport;
+
+		if (FailureCounts.IsValidIndex(SequenceIndex))
+		{
+			FailureCounts[SequenceIndex]++;
+		}
+	}
+
 	return false;
 }
 
-bool FTileGenWorker::TryPlaceTile(const FTileData& NewTile)
+bool FTileGenWorker::TryPlaceTile(const FTileData& NewTile, FTileGenReport& StepReport)
 {
 	if (TileMap.IsEmpty())
 	{
 		TileMap.Emplace(NewTile, FTransform(Params.Rotation, Params.Location), true);
+		CommitPlan(0);
 		return true;
 	}
 
@@ -179,10 +432,11 @@ bool FTileGenWorker::TryPlaceTile(const FTileData& NewTile)
 	TArray<TPair<int32, int32>> OpenPortals;
 	int32 PlanIndex = TileMap.Num() - 1;
 	int32 Depth = 0;
+	int32 BranchDepth = GetBranchDepth(TileMap.Num());
 
 	// Traverse the tile map from the top-down like a tree and add any open portals to the list.
 	// Traversal continues until an invalid parent is found or the branch length is reached.
-	while (0 <= PlanIndex && PlanIndex < TileMap.Num() && Depth < Params.Branch)
+	while (0 <= PlanIndex && PlanIndex < TileMap.Num() && Depth < BranchDepth)
 	{
 		const FTileGraphPlan& PlanValue = TileMap[PlanIndex];
 
@@ -207,6 +461,9 @@ bool FTileGenWorker::TryPlaceTile(const FTileData& NewTile)
 		++Depth;
 	}
 
+	// Every candidate sees the same tile map, so the open portal count is shared across the step.
+	StepReport.OpenPortals = OpenPortals.Num();
+
 	// Gather portals on the new tile.
 	TArray<int32> TilePortals;
 
@@ -231,6 +488,9 @@ bool FTileGenWorker::TryPlaceTile(const FTileData& NewTile)
 			{
 				FTransform NewTransform = FTilePortal::ConnectionTransform(NewPortal, MapPortal);
 
+				StepReport.Connections++;
+				Placements++;
+
 				if (CanPlaceTile(NewTile, NewTransform))
 				{
 					// Placement check successful; create the tile plan now.
@@ -244,17 +504,137 @@ bool FTileGenWorker::TryPlaceTile(const FTileData& NewTile)
 
 					// Append the plan and exit.
 					TileMap.Emplace(NewPlan);
+					CommitPlan(TileMap.Num() - 1);
 					return true;
 				}
+
+				StepReport.Collisions++;
+			}
+		}
+	}
+
+	return false;
+}
+
+int32 FTileGenWorker::GetBranchDepth(int32 SequenceIndex) const
+{
+	if (Params.bAdaptive && FailureCounts.IsValidIndex(SequenceIndex))
+	{
+		return Params.Branch + FailureCounts[SequenceIndex];
+	}
+
+	return Params.Branch;
+}
+
+bool FTileGenWorker::HandleCoreFailure()
+{
+	if (bStopThread)
+	{
+		return false;
+	}
+
+	// Remember the longest partial sequence so that an exhausted budget can fall back on it.
+	if (BestMap.Num() < TileMap.Num())
+	{
+		BestMap = TileMap;
+	}
+
+	return IsOverBudget() && PlaceBestEffort();
+}
+
+bool FTileGenWorker::PlaceBestEffort()
+{
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileGenWorker::PlaceBestEffort [Tiles=%i]"), BestMap.Num());
+
+	TArray<FTileData>& Palette = TilePalettes[*ETileScheme::Exit];
+
+	// The best-effort map replaces the current attempt, so it starts a new epoch.
+	Epoch++;
+
+	// Trim the partial sequence one tile at a time, starting from its full length. Each trimmed
+	// map keeps its start tile, so the shortest possible result is a start tile and an exit.
+	for (int32 Length = BestMap.Num(); 0 < Length; Length--)
+	{
+		TileMap.Empty(Length + 1);
+		TileMap.Append(BestMap.GetData(), Length);
+
+		// Vacate any portals that connected to trimmed tiles.
+		for (FTileGraphPlan& Plan : TileMap)
+		{
+			for (FTileGraphPortal& Portal : Plan.Portals)
+			{
+				if (Length <= Portal.ConnectionIndex)
+				{
+					Portal.ConnectionIndex = -1;
+				}
+			}
+		}
+
+		ShuffleArray(Palette);
+
+		for (const FTileData& NewTile : Palette)
+		{
+			FTileGenReport StepReport;
+
+			if (TryPlaceTile(NewTile, StepReport))
+			{
+				Quality = ETileGenQuality::BestEffort;
+				CoreLength = TileMap.Num();
+
+				// The exit tile was committed when placed, but the trimmed sequence before it was
+				// committed under an earlier epoch, so commit it again.
+				for (int32 PlanIndex = 0; PlanIndex < Length; PlanIndex++)
+				{
+					CommitPlan(PlanIndex);
+				}
+
+				// Skip the tick interface ahead to the terminal branch.
+				Progress.Set(Params.Length);
+				return true;
 			}
 		}
 	}
 
+	TileMap.Empty();
 	return false;
 }
 
+bool FTileGenWorker::CheckBudget()
+{
+	if (!bBudgetExhausted)
+	{
+		BudgetChecks++;
+
+		if (0 <= BudgetCutoff)
+		{
+			bBudgetExhausted = 0 < BudgetCutoff && BudgetCutoff <= BudgetChecks;
+		}
+		else
+		{
+			bool bOverTime = 0 < Params.TimeBudget && Params.TimeBudget < FPlatformTime::Seconds() - BudgetStart;
+			bool bOverPlacements = 0 < Params.PlacementBudget && Params.PlacementBudget <= Placements;
+
+			bBudgetExhausted = bOverTime || bOverPlacements;
+		}
+
+		if (bBudgetExhausted)
+		{
+			BudgetCutoff = BudgetChecks;
+		}
+	}
+
+	return bBudgetExhausted;
+}
+
+bool FTileGenWorker::IsOverBudget() const
+{
+	return bBudgetExhausted;
+}
+
 void FTileGenWorker::PlaceTerminals(int32 PlanIndex)
 {
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileGenWorker::PlaceTerminals [Tile=%i, Portals=%i]"), PlanIndex, TileMap[PlanIndex].Portals.Num());
+
 	for (int32 Portal = 0; Portal < TileMap[PlanIndex].Portals.Num() && !bStopThread; Portal++)
 	{
 		if (TileMap[PlanIndex].IsOpenPortal(Portal))
@@ -295,6 +675,7 @@ void FTileGenWorker::TryPlaceTerminal(int32 PlanIndex, int32 Portal)
 
 					// Append the plan and exit.
 					TileMap.Emplace(NewPlan);
+					CommitPlan(TileMap.Num() - 1);
 					return;
 				}
 			}
@@ -302,6 +683,15 @@ void FTileGenWorker::TryPlaceTerminal(int32 PlanIndex, int32 Portal)
 	}
 }
 
+void FTileGenWorker::CommitPlan(int32 PlanIndex)
+{
+	// Prefetching uses the commits to raise the priority of each placed level.
+	if (Params.bPipelineStreaming || Params.bPrefetchLevels)
+	{
+		Commits.Enqueue({ TileMap[PlanIndex], PlanIndex, Epoch });
+	}
+}
+
 bool FTileGenWorker::CanPlaceTile(const FTileData& NewTile, const FTransform& Transform) const
 {
 	for (const FTileBound& NewBound : NewTile.Bounds)
@@ -3,9 +3,12 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/Queue.h"
 #include "HAL/Runnable.h"
 #include "TileData/TileScheme.h"
+#include "TileGen/TileGenAction.h"
 #include "TileGen/TileGenParams.h"
+#include "TileGen/TileGenReport.h"
 #include "Misc/SingleThreadRunnable.h"
 
 class FRunnableThread;
@@ -28,8 +31,9 @@ public:
 	 * @param InParams Tile map generation parameters.
 	 * @param InTileList Loaded tiles to use in the generated tile map.
 	 * @param InDelegate Delegate invoked when the generation thread exits.
+	 * @param InBudgetCutoff Budget cutoff recorded when the map was first generated, if replaying.
 	 */
-	FTileGenWorker(const FTileGenParams& InParams, const TArray<UTileDataAsset*>& InTileList, const FSimpleDelegate& InDelegate);
+	FTileGenWorker(const FTileGenParams& InParams, const TArray<UTileDataAsset*>& InTileList, const FSimpleDelegate& InDelegate, int32 InBudgetCutoff = INDEX_NONE);
 
 	/**
 	 * Safely discards the worker and its thread. If the thread has not finished running when this
@@ -42,6 +46,16 @@ private:
 	/** Creates and starts a worker thread instance. */
 	void Start();
 
+	/**
+	 * Statically analyzes the tile palettes for problems that would cause every generation attempt
+	 * to fail. Checks that each scheme in the sequence has enough tiles, that each step can share
+	 * a portal size with the steps before it, and that every portal size in use has a terminal.
+	 *
+	 * @param OutDiagnostic Explanation of the first problem found, if any.
+	 * @return True if the palettes can feasibly produce a valid tile map.
+	 */
+	bool CheckFeasibility(FString& OutDiagnostic) const;
+
 	/** Handles pre-loop worker initialization. */
 	virtual bool Init() override;
 
@@ -73,9 +87,49 @@ private:
 	 * tile map if a point is found.
 	 *
 	 * @param NewTile Tile to attempt to add to the tile map.
+	 * @param StepReport Report in which to accumulate portal and collision statistics.
 	 * @return True if the tile was attached successfully.
 	 */
-	bool TryPlaceTile(const FTileData& NewTile);
+	bool TryPlaceTile(const FTileData& NewTile, FTileGenReport& StepReport);
+
+	/**
+	 * Returns the branch search depth to use when placing the tile at the given sequence index.
+	 * In adaptive mode, the depth widens by one for each previous failure at that index.
+	 *
+	 * @param SequenceIndex Scheme sequence index being placed.
+	 * @return Maximum tree depth to search for open portals.
+	 */
+	int32 GetBranchDepth(int32 SequenceIndex) const;
+
+	/**
+	 * Handles a failed core placement. Records the partial tile map if it is the longest found so
+	 * far, and falls back on a best-effort map if the generation budget has run out.
+	 *
+	 * @return True if a best-effort core sequence replaced the failed one.
+	 */
+	bool HandleCoreFailure();
+
+	/**
+	 * Rebuilds the tile map from the longest partial sequence found so far, trimming tiles from
+	 * its end until an exit tile can be attached. Ignores the generation budget, since the work
+	 * is bounded by the length of the partial sequence.
+	 *
+	 * @return True if an exit tile was attached and the map can be used.
+	 */
+	bool PlaceBestEffort();
+
+	/**
+	 * Counts a budget check and evaluates the generation budget. Once exhausted, the budget stays
+	 * exhausted and the number of the check that exhausted it is recorded as the budget cutoff.
+	 * Replays ignore the time and placement budgets and exhaust at the recorded cutoff instead (or
+	 * never, if the cutoff is zero), which makes time-limited maps reproducible from their seed.
+	 *
+	 * @return True if the generation budget is exhausted.
+	 */
+	bool CheckBudget();
+
+	/** @return True if the generation budget has been exhausted. */
+	bool IsOverBudget() const;
 
 	/**
 	 * Attempts to attach terminal tiles to any vacant portals left on the given tile.
@@ -92,6 +146,14 @@ private:
 	 */
 	void TryPlaceTerminal(int32 PlanIndex, int32 Portal);
 
+	/**
+	 * Publishes the plan at the given tile map index to the game thread under the current epoch,
+	 * if the parameters pipeline streaming.
+	 *
+	 * @param PlanIndex Tile map index of the accepted plan.
+	 */
+	void CommitPlan(int32 PlanIndex);
+
 	/**
 	 * Checks to see if the given tile can be placed at the given transform by checking for any
 	 * collisions with the existing tile map.
@@ -128,6 +190,9 @@ private:
 	/** Generated scheme sequence. */
 	TArray<ETileScheme> Sequence;
 
+	/** Objective tiles removed from the objective palette during the current attempt. */
+	TArray<FTileData> UsedObjectives;
+
 	/** Current generated tile map. */
 	TArray<FTileGraphPlan> TileMap;
 
@@ -139,4 +204,46 @@ private:
 
 	/** Tracks worker progress. */
 	FThreadSafeCounter Progress;
+
+	/** Outcome of the most recent generation attempt. */
+	FTileGenReport Report;
+
+	/** Number of failures recorded at each sequence index across all attempts. */
+	TArray<int32> FailureCounts;
+
+	/** Quality of the current tile map. */
+	ETileGenQuality Quality = ETileGenQuality::None;
+
+	/** Number of core (non-terminal) tiles at the front of the current tile map. */
+	int32 CoreLength = 0;
+
+	/** Longest partial core sequence found across all attempts. */
+	TArray<FTileGraphPlan> BestMap;
+
+	/** Platform time at which the generation budget began. */
+	double BudgetStart = 0;
+
+	/** Number of tile placement checks made across all attempts. */
+	int32 Placements = 0;
+
+	/** Number of budget checks made across all attempts. */
+	int32 BudgetChecks = 0;
+
+	/**
+	 * Budget check at which the budget was (or will be, when replaying) exhausted. Zero if the
+	 * budget was never exhausted, and INDEX_NONE if the worker is not replaying a recorded map.
+	 */
+	int32 BudgetCutoff = INDEX_NONE;
+
+	/** True once the generation budget is exhausted. */
+	bool bBudgetExhausted = false;
+
+	/** Hash of the tile data the worker was created with. */
+	uint32 TilesetHash = 0;
+
+	/** Tile plans accepted by the worker thread, waiting to be consumed by the game thread. */
+	TQueue<FTileGenCommit, EQueueMode::Spsc> Commits;
+
+	/** Number of times the worker has started a new tile map, across all attempts. */
+	int32 Epoch = 0;
 };
@@ -11,6 +11,8 @@ FTileGraphPortal::FTileGraphPortal(const FTilePortal& BasePortal, const FTransfo
 
 FTileGraphPlan::FTileGraphPlan(const FTileData& TemplateData, const FTransform& Transform, bool bGraphRoot)
 	: FTilePlan(TemplateData.Level, Transform.GetLocation(), Transform.Rotator())
+	, PortalDistances(TemplateData.PortalDistances)
+	, NumTemplatePortals(TemplateData.Portals.Num())
 {
 	if (bGraphRoot)
 	{
@@ -18,9 +20,9 @@ FTileGraphPlan::FTileGraphPlan(const FTileData& TemplateData, const FTransform&
 		Portals.GetData()->ConnectionIndex = -2;
 	}
 
-	for (const FTilePortal& Portal : TemplateData.Portals)
+	for (int32 Index = 0; Index < TemplateData.Portals.Num(); Index++)
 	{
-		Portals.Emplace(Portal, Transform);
+		Portals.Emplace(TemplateData.Portals[Index], Transform).TemplateIndex = Index;
 	}
 
 	for (const FTileBound& Bound : TemplateData.Bounds)
@@ -37,6 +39,7 @@ void FTileGraphPlan::SetConnection(int32 Index, int32 GraphIndex, bool bParent)
 	if (bParent)
 	{
 		Portals.Swap(0, Index);
+		Parent = GraphIndex;
 	}
 }
 
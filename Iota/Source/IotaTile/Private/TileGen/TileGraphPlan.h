@@ -15,6 +15,9 @@ struct FTileGraphPortal : public FTilePortal
 	/** Tile map index to which this portal connects. Negative values indicate a vacant portal. */
 	int32 ConnectionIndex = -1;
 
+	/** Index of the portal within its tile data template. Negative for the root placeholder. */
+	int32 TemplateIndex = INDEX_NONE;
+
 	/**
 	 * Defines a new graph portal by transforming the provided base portal.
 	 *
@@ -33,6 +36,12 @@ struct FTileGraphPlan : public FTilePlan
 	/** List of tile collision bounds. */
 	TArray<FTileBound> Bounds;
 
+	/** Walking distance between each pair of template portals, in template portal order. */
+	TArray<float> PortalDistances;
+
+	/** Number of portals in the tile data template. */
+	int32 NumTemplatePortals = 0;
+
 	/**
 	 * Defines a new generation plan by applying a world transform to a provided tile template.
 	 *
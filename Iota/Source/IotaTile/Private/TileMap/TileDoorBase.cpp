@@ -1,22 +1,101 @@
 // Copyright Sydney Fonderie, 2023. All Rights Reserved.
 
 #include "TileMap/TileDoorBase.h"
+#include "TileMap/TileMapComponent.h"
+#include "TileSubsystem.h"
 #include "Components/SceneComponent.h"
+#include "Engine/World.h"
 #include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "Net/UnrealNetwork.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(TileDoorBase)
 
+static TAutoConsoleVariable<bool> CVarTileDoorDormancy(
+	TEXT("IotaTile.DoorDormancy"),
+	true,
+	TEXT("If true, tile doors stay net dormant and only wake when their lock or seal state changes. ")
+	TEXT("Disable to keep doors awake while debugging door replication. Applies to doors spawned afterwards."),
+	ECVF_Default);
+
 ATileDoorBase::ATileDoorBase()
 {
 	PrimaryActorTick.bCanEverTick = true;
 
+	// Doors only replicate once so that clients can spawn them. Lock and seal state is batched
+	// into the tile map component instead, so the door channel can go dormant immediately.
 	SetReplicates(true);
+	NetDormancy = DORM_DormantAll;
 
 	DoorBaseComponent = CreateDefaultSubobject<USceneComponent>(TEXT("DoorPivot"));
 	DoorBaseComponent->Mobility = EComponentMobility::Static;
 	RootComponent = DoorBaseComponent;
 }
 
+void ATileDoorBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME_CONDITION(ATileDoorBase, DoorIndex, COND_InitialOnly);
+	DOREPLIFETIME_CONDITION(ATileDoorBase, bIsLocked, COND_Custom);
+	DOREPLIFETIME_CONDITION(ATileDoorBase, bIsSealed, COND_Custom);
+}
+
+void ATileDoorBase::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	bool bFallback = !IsStateBatched();
+	DOREPLIFETIME_ACTIVE_OVERRIDE(ATileDoorBase, bIsLocked, bFallback);
+	DOREPLIFETIME_ACTIVE_OVERRIDE(ATileDoorBase, bIsSealed, bFallback);
+}
+
+void ATileDoorBase::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (HasAuthority() && !CVarTileDoorDormancy.GetValueOnGameThread())
+	{
+		SetNetDormancy(DORM_Awake);
+	}
+
+	if (DoorIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (UTileSubsystem* TileSubsystem = GetWorld()->GetSubsystem<UTileSubsystem>())
+	{
+		TileSubsystem->RegisterDoor(this);
+
+		// Servers own the door state, so they publish it. Clients pull whatever state has already
+		// arrived, and any later changes are pushed to them by the tile map component.
+		if (HasAuthority())
+		{
+			PublishDoorState();
+		}
+		else if (UTileMapComponent* MapComponent = TileSubsystem->GetMapComponent())
+		{
+			bool bLocked = bIsLocked;
+			bool bSealed = bIsSealed;
+
+			if (MapComponent->GetDoorState(DoorIndex, bLocked, bSealed))
+			{
+				ApplyDoorState(bLocked, bSealed);
+			}
+		}
+	}
+}
+
+void ATileDoorBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UTileSubsystem* TileSubsystem = GetWorld()->GetSubsystem<UTileSubsystem>())
+	{
+		TileSubsystem->UnregisterDoor(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ATileDoorBase::Tick(float DeltaTime)
 {
 	DoorSlideState += DeltaTime * (IsDoorOpen() ? 1 : -1);
@@ -69,11 +148,76 @@ void ATileDoorBase::SetSlideDuration(float NewDuration)
 void ATileDoorBase::SetLocked(bool bLocked)
 {
 	bIsLocked = bLocked;
+	PublishDoorState();
+	FlushDoorState();
 	OnLockUpdate();
 }
 
 void ATileDoorBase::SetSealed(bool bSealed)
 {
 	bIsSealed = bSealed;
+	PublishDoorState();
+	FlushDoorState();
+	OnLockUpdate();
+}
+
+void ATileDoorBase::ApplyDoorState(bool bLocked, bool bSealed)
+{
+	if (bIsLocked != bLocked || bIsSealed != bSealed)
+	{
+		bIsLocked = bLocked;
+		bIsSealed = bSealed;
+		OnLockUpdate();
+	}
+}
+
+void ATileDoorBase::ReleaseDoorIndex()
+{
+	if (UTileSubsystem* TileSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UTileSubsystem>() : nullptr)
+	{
+		TileSubsystem->UnregisterDoor(this);
+	}
+
+	DoorIndex = INDEX_NONE;
+}
+
+void ATileDoorBase::PublishDoorState() const
+{
+	if (DoorIndex == INDEX_NONE || !HasAuthority() || !GetWorld())
+	{
+		return;
+	}
+
+	if (UTileSubsystem* TileSubsystem = GetWorld()->GetSubsystem<UTileSubsystem>())
+	{
+		if (UTileMapComponent* MapComponent = TileSubsystem->GetMapComponent())
+		{
+			MapComponent->SetDoorState(DoorIndex, bIsLocked, bIsSealed);
+		}
+	}
+}
+
+void ATileDoorBase::OnRep_DoorState()
+{
 	OnLockUpdate();
 }
+
+bool ATileDoorBase::IsStateBatched() const
+{
+	if (DoorIndex == INDEX_NONE || !GetWorld())
+	{
+		return false;
+	}
+
+	UTileSubsystem* TileSubsystem = GetWorld()->GetSubsystem<UTileSubsystem>();
+	return TileSubsystem && TileSubsystem->GetMapComponent();
+}
+
+void ATileDoorBase::FlushDoorState()
+{
+	// Batched doors never need to wake, since their state replicates through the component.
+	if (HasAuthority() && !IsStateBatched())
+	{
+		FlushNetDormancy();
+	}
+}
@@ -0,0 +1,236 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#include "TileMap/TileGraphReplicationNode.h"
+#include "TileMap/TileMapGraph.h"
+#include "TileSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "IotaTileStats.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(TileGraphReplicationNode)
+
+UTileGraphReplicationNode::UTileGraphReplicationNode()
+{
+	bRequiresPrepareForReplicationCall = true;
+}
+
+void UTileGraphReplicationNode::NotifyAddNetworkActor(const FNetworkActorInfo& ActorInfo)
+{
+	RefreshGraph();
+
+	int32 TileIndex = FindActorTile(ActorInfo.Actor);
+
+	ActorTiles.Add(ActorInfo.Actor, TileIndex);
+	GetBucket(TileIndex).Add(ActorInfo.Actor);
+	TrackLooseActor(ActorInfo.Actor, TileIndex);
+}
+
+bool UTileGraphReplicationNode::NotifyRemoveNetworkActor(const FNetworkActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	int32 TileIndex = INDEX_NONE;
+
+	if (ActorTiles.RemoveAndCopyValue(ActorInfo.Actor, TileIndex))
+	{
+		LooseLocations.Remove(ActorInfo.Actor);
+		return GetBucket(TileIndex).RemoveFast(ActorInfo.Actor);
+	}
+
+	return false;
+}
+
+void UTileGraphReplicationNode::NotifyResetAllNetworkActors()
+{
+	ActorTiles.Empty();
+	TileActors.Empty();
+	LooseActors.Reset();
+	LooseLocations.Empty();
+}
+
+void UTileGraphReplicationNode::PrepareForReplication()
+{
+	TILE_TRACE_SCOPE("TileGraphReplicationNode::PrepareForReplication");
+
+	RefreshGraph();
+
+	TSharedPtr<const FTileMapGraph> Graph = CachedGraph.Pin();
+
+	if (!Graph.IsValid())
+	{
+		return;
+	}
+
+	// Most actors stay in their tile between frames, so only actors that have left their tile
+	// need a search, and that search starts from the tile they left. Actors outside every tile
+	// have no tile to start from, so they are only searched for again once they have moved.
+	float RescanDistanceSquared = FMath::Square(LooseRescanDistance);
+
+	for (TPair<FActorRepListType, int32>& ActorTile : ActorTiles)
+	{
+		const AActor* Actor = ActorTile.Key;
+
+		if (!IsValid(Actor))
+		{
+			continue;
+		}
+
+		if (0 <= ActorTile.Value)
+		{
+			if (Graph->GetNodeData(ActorTile.Value).Contains(Actor->GetActorLocation()))
+			{
+				continue;
+			}
+		}
+		else if (const FVector* LooseLocation = LooseLocations.Find(ActorTile.Key))
+		{
+			if (FVector::DistSquared(*LooseLocation, Actor->GetActorLocation()) < RescanDistanceSquared)
+			{
+				continue;
+			}
+		}
+
+		int32 TileIndex = FindActorTile(Actor, ActorTile.Value);
+
+		if (TileIndex != ActorTile.Value)
+		{
+			GetBucket(ActorTile.Value).RemoveFast(ActorTile.Key);
+			GetBucket(TileIndex).Add(ActorTile.Key);
+			ActorTile.Value = TileIndex;
+		}
+
+		TrackLooseActor(ActorTile.Key, TileIndex);
+	}
+}
+
+void UTileGraphReplicationNode::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	TILE_TRACE_SCOPE("TileGraphReplicationNode::GatherActorListsForConnection");
+
+	if (LooseActors.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(LooseActors);
+	}
+
+	TSharedPtr<const FTileMapGraph> Graph = CachedGraph.Pin();
+
+	if (!Graph.IsValid())
+	{
+		return;
+	}
+
+	int32& ConnectionTile = ConnectionTiles.FindOrAdd(&Params.ConnectionManager, INDEX_NONE);
+	TSet<int32, DefaultKeyFuncs<int32>, TInlineSetAllocator<32>> GatheredTiles;
+
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		int32 TileIndex = Graph->FindTile(Viewer.ViewLocation, ConnectionTile);
+		ConnectionTile = TileIndex;
+
+		// Viewers outside the map have no meaningful graph distance, so gather everything.
+		if (TileIndex == INDEX_NONE)
+		{
+			for (int32 Index = 0; Index < TileActors.Num(); Index++)
+			{
+				GatheredTiles.Add(Index);
+			}
+
+			break;
+		}
+
+		for (int32 Neighbor : GetNeighborhood(*Graph, TileIndex))
+		{
+			GatheredTiles.Add(Neighbor);
+		}
+	}
+
+	for (int32 TileIndex : GatheredTiles)
+	{
+		if (TileActors.IsValidIndex(TileIndex) && TileActors[TileIndex].Num() > 0)
+		{
+			Params.OutGatheredReplicationLists.AddReplicationActorList(TileActors[TileIndex]);
+		}
+	}
+}
+
+const TArray<int32>& UTileGraphReplicationNode::GetNeighborhood(const FTileMapGraph& Graph, int32 TileIndex)
+{
+	if (const TArray<int32>* Cached = Neighborhoods.Find(TileIndex))
+	{
+		return *Cached;
+	}
+
+	// The search queue lists every tile it reached, nearest first, which is exactly the
+	// neighborhood. Scratch buffers are kept between searches to avoid reallocating them.
+	Graph.FindHopDistances(MakeArrayView(&TileIndex, 1), HopDistances, Scratch, HopRadius);
+
+	return Neighborhoods.Add(TileIndex, Scratch.Queue);
+}
+
+int32 UTileGraphReplicationNode::FindActorTile(const AActor* Actor, int32 HintIndex) const
+{
+	TSharedPtr<const FTileMapGraph> Graph = CachedGraph.Pin();
+
+	if (Graph.IsValid() && IsValid(Actor))
+	{
+		return Graph->FindTile(Actor->GetActorLocation(), HintIndex);
+	}
+
+	return INDEX_NONE;
+}
+
+FActorRepListRefView& UTileGraphReplicationNode::GetBucket(int32 TileIndex)
+{
+	return TileActors.IsValidIndex(TileIndex) ? TileActors[TileIndex] : LooseActors;
+}
+
+void UTileGraphReplicationNode::RefreshGraph()
+{
+	TSharedPtr<const FTileMapGraph> Graph;
+
+	if (GraphGlobals.IsValid() && GraphGlobals->World)
+	{
+		if (UTileSubsystem* TileSubsystem = GraphGlobals->World->GetSubsystem<UTileSubsystem>())
+		{
+			Graph = TileSubsystem->GetMapGraph();
+		}
+	}
+
+	int32 GraphSize = Graph.IsValid() ? Graph->GetSize() : 0;
+
+	if (Graph == CachedGraph.Pin() && GraphSize == CachedSize)
+	{
+		return;
+	}
+
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileGraphReplicationNode::RebuildBuckets [Tiles=%i, Actors=%i]"), GraphSize, ActorTiles.Num());
+
+	CachedGraph = Graph;
+	CachedSize = GraphSize;
+
+	Neighborhoods.Empty();
+	ConnectionTiles.Empty();
+
+	// Rebucket every tracked actor against the new graph.
+	TileActors.Empty(GraphSize);
+	TileActors.SetNum(GraphSize);
+	LooseActors.Reset();
+	LooseLocations.Empty();
+
+	for (TPair<FActorRepListType, int32>& ActorTile : ActorTiles)
+	{
+		ActorTile.Value = FindActorTile(ActorTile.Key);
+		GetBucket(ActorTile.Value).Add(ActorTile.Key);
+		TrackLooseActor(ActorTile.Key, ActorTile.Value);
+	}
+}
+
+void UTileGraphReplicationNode::TrackLooseActor(FActorRepListType Actor, int32 TileIndex)
+{
+	if (TileActors.IsValidIndex(TileIndex) || !IsValid(Actor))
+	{
+		LooseLocations.Remove(Actor);
+	}
+	else
+	{
+		LooseLocations.Add(Actor, Actor->GetActorLocation());
+	}
+}
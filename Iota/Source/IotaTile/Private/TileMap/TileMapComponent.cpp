@@ -0,0 +1,235 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#include "TileMap/TileMapComponent.h"
+#include "TileMap/TileDoorBase.h"
+#include "TileSubsystem.h"
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+#include "IotaTileStats.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(TileMapComponent)
+
+void FTileMapItem::PostReplicatedAdd(const FTileMapArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->StreamItem(*this);
+	}
+}
+
+UTileMapComponent::UTileMapComponent()
+{
+	SetIsReplicatedByDefault(true);
+}
+
+void UTileMapComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// Bind after property initialization, which would otherwise copy the archetype owner.
+	TileMap.Owner = this;
+}
+
+void UTileMapComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(UTileMapComponent, TileMap);
+	DOREPLIFETIME(UTileMapComponent, DoorStates);
+}
+
+void UTileMapComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UTileSubsystem* TileSubsystem = GetWorld()->GetSubsystem<UTileSubsystem>())
+	{
+		TileSubsystem->RegisterMapComponent(this);
+	}
+}
+
+void UTileMapComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UTileSubsystem* TileSubsystem = GetWorld()->GetSubsystem<UTileSubsystem>())
+	{
+		if (TileSubsystem->GetMapComponent() == this)
+		{
+			TileSubsystem->RegisterMapComponent(nullptr);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UTileMapComponent::SetTileMap(const TArray<FTilePlan>& NewTileMap, int32 NewMapIndex)
+{
+	if (!GetOwner()->HasAuthority() || NewMapIndex <= MapIndex)
+	{
+		return;
+	}
+
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileMapComponent::SetTileMap [Map=%i, Tiles=%i]"), NewMapIndex, NewTileMap.Num());
+
+	MapIndex = NewMapIndex;
+
+	// Replace every entry. Clients discard the old map once the first new entry arrives.
+	TileMap.Items.Empty(NewTileMap.Num());
+
+	for (int32 PlanIndex = 0; PlanIndex < NewTileMap.Num(); PlanIndex++)
+	{
+		FTileMapItem& Item = TileMap.Items.AddDefaulted_GetRef();
+		Item.Plan = NewTileMap[PlanIndex];
+		Item.MapIndex = MapIndex;
+		Item.PlanIndex = PlanIndex;
+		Item.MapTileCount = NewTileMap.Num();
+	}
+
+	TileMap.MarkArrayDirty();
+
+	// Door indices restart with each map, so the old door states no longer apply.
+	DoorStates.Empty();
+
+	// Stream the map on the server as well, since the server never receives replication callbacks.
+	if (UTileSubsystem* TileSubsystem = GetWorld()->GetSubsystem<UTileSubsystem>())
+	{
+		TileSubsystem->SetLiveTileMap(NewTileMap, MapIndex);
+	}
+}
+
+void UTileMapComponent::SetGraphTileMap()
+{
+	if (UTileSubsystem* TileSubsystem = GetWorld()->GetSubsystem<UTileSubsystem>())
+	{
+		TArray<FTilePlan> GraphTileMap;
+		int32 GraphMapIndex = 0;
+
+		TileSubsystem->GetGraphTileMap(GraphTileMap, GraphMapIndex);
+		SetTileMap(GraphTileMap, GraphMapIndex);
+	}
+}
+
+void UTileMapComponent::AppendTiles(const TArray<FTilePlan>& NewTiles)
+{
+	if (!GetOwner()->HasAuthority() || MapIndex <= 0)
+	{
+		return;
+	}
+
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileMapComponent::AppendTiles [Map=%i, Tiles=%i]"), MapIndex, NewTiles.Num());
+
+	UTileSubsystem* TileSubsystem = GetWorld()->GetSubsystem<UTileSubsystem>();
+	int32 MapTileCount = TileMap.Items.Num() + NewTiles.Num();
+
+	for (const FTilePlan& TilePlan : NewTiles)
+	{
+		FTileMapItem& Item = TileMap.Items.AddDefaulted_GetRef();
+		Item.Plan = TilePlan;
+		Item.MapIndex = MapIndex;
+		Item.PlanIndex = TileMap.Items.Num() - 1;
+		Item.MapTileCount = MapTileCount;
+
+		// Marking each new item dirty sends only the new items to clients.
+		TileMap.MarkItemDirty(Item);
+
+		if (TileSubsystem)
+		{
+			TileSubsystem->AddLiveTile(Item.Plan, Item.MapIndex, Item.PlanIndex);
+		}
+	}
+}
+
+void UTileMapComponent::SetDoorState(int32 DoorIndex, bool bLocked, bool bSealed)
+{
+	if (!GetOwner()->HasAuthority() || DoorIndex < 0)
+	{
+		return;
+	}
+
+	int32 ByteIndex = DoorIndex / 4;
+	int32 Shift = DoorIndex % 4 * 2;
+
+	if (DoorStates.Num() <= ByteIndex)
+	{
+		DoorStates.SetNumZeroed(ByteIndex + 1);
+	}
+
+	uint8 State = (bLocked ? 1 : 0) | (bSealed ? 2 : 0);
+	DoorStates[ByteIndex] = static_cast<uint8>((DoorStates[ByteIndex] & ~(3 << Shift)) | State << Shift);
+}
+
+bool UTileMapComponent::GetDoorState(int32 DoorIndex, bool& bOutLocked, bool& bOutSealed) const
+{
+	int32 ByteIndex = DoorIndex / 4;
+
+	if (DoorIndex < 0 || DoorStates.Num() <= ByteIndex)
+	{
+		return false;
+	}
+
+	uint8 State = static_cast<uint8>(DoorStates[ByteIndex] >> DoorIndex % 4 * 2);
+	bOutLocked = State & 1;
+	bOutSealed = State & 2;
+
+	return true;
+}
+
+int32 UTileMapComponent::GetMapIndex() const
+{
+	return MapIndex;
+}
+
+void UTileMapComponent::StreamItem(const FTileMapItem& Item)
+{
+	UTileSubsystem* TileSubsystem = GetWorld()->GetSubsystem<UTileSubsystem>();
+
+	if (!TileSubsystem)
+	{
+		return;
+	}
+
+	// The first entry of a newer map replaces the active map. Entries from older maps can still
+	// arrive if the server replaced the map mid-replication, and are dropped by the subsystem.
+	if (TileSubsystem->GetActiveIndex() < Item.MapIndex)
+	{
+		TileSubsystem->BeginLiveTileMap(Item.MapIndex, Item.MapTileCount);
+	}
+
+	// Appended entries carry the grown map size, so readiness also waits for them.
+	TileSubsystem->ExpectLiveTiles(Item.MapIndex, Item.MapTileCount);
+
+	MapIndex = FMath::Max(MapIndex, Item.MapIndex);
+	TileSubsystem->AddLiveTile(Item.Plan, Item.MapIndex, Item.PlanIndex);
+}
+
+void UTileMapComponent::OnRep_DoorStates()
+{
+	UTileSubsystem* TileSubsystem = GetWorld()->GetSubsystem<UTileSubsystem>();
+
+	if (!TileSubsystem)
+	{
+		return;
+	}
+
+	// Only visit the bytes that changed since the last update. Doors that have not spawned yet
+	// will read their state from the component when they begin play.
+	for (int32 ByteIndex = 0; ByteIndex < DoorStates.Num(); ByteIndex++)
+	{
+		if (AppliedStates.IsValidIndex(ByteIndex) && AppliedStates[ByteIndex] == DoorStates[ByteIndex])
+		{
+			continue;
+		}
+
+		for (int32 DoorIndex = ByteIndex * 4; DoorIndex < ByteIndex * 4 + 4; DoorIndex++)
+		{
+			bool bLocked = false;
+			bool bSealed = false;
+
+			if (ATileDoorBase* Door = TileSubsystem->FindDoor(DoorIndex))
+			{
+				GetDoorState(DoorIndex, bLocked, bSealed);
+				Door->ApplyDoorState(bLocked, bSealed);
+			}
+		}
+	}
+
+	AppliedStates = DoorStates;
+}
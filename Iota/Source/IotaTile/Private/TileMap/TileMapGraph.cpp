@@ -2,6 +2,7 @@
 
 #include "TileMap/TileMapGraph.h"
 #include "Engine/World.h"
+#include "IotaTileStats.h"
 
 FTileDoor::~FTileDoor()
 {
@@ -11,11 +12,50 @@ FTileDoor::~FTileDoor()
 	}
 }
 
+FTileNode::FTileNode(const FTilePlan& InPlan, const TArray<FTileBound>& InBounds, const TArray<float>& InPortalDistances, int32 InNumPortals)
+	: FTilePlan(InPlan)
+	, Bounds(InBounds)
+	, PortalDistances(InPortalDistances)
+	, NumPortals(InNumPortals)
+{
+	// Complete constructor.
+}
+
+float FTileNode::GetPortalDistance(int32 From, int32 To) const
+{
+	// Tiles exported before distances were added carry no matrix, or a matrix of the wrong size.
+	if (PortalDistances.Num() != NumPortals * NumPortals || From < 0 || NumPortals <= From || To < 0 || NumPortals <= To)
+	{
+		return -1.0f;
+	}
+
+	return PortalDistances[From * NumPortals + To];
+}
+
+bool FTileNode::Contains(const FVector& Point) const
+{
+	for (const FTileBound& Bound : Bounds)
+	{
+		if (Bound.Contains(Point))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 FTileMapGraph::FTileMapGraph(UWorld* InWorld) : World(InWorld)
 {
 	// Default constructor.
 }
 
+FTileMapGraph::~FTileMapGraph()
+{
+	// Seals are not owned by graph edges, so they must be destroyed along with the graph.
+	Empty();
+}
+
 UWorld* FTileMapGraph::GetWorld() const
 {
 	return World;
@@ -28,17 +68,29 @@ bool FTileMapGraph::IsLive() const
 
 void FTileMapGraph::SetLive(bool bLive)
 {
-	bLiveGraph = bLive;
+	LLM_SCOPE_BYTAG(IotaTile_Doors);
+
+	// Retiring graphs are on their way out, so they never spawn new doors.
+	bLiveGraph = bLive && !bRetiring;
 
 	if (bLiveGraph)
 	{
-		for (const FTileDoorRequest& Request : DoorRequests)
+		TILE_TRACE_SCOPE_TEXT(TEXT("TileMapGraph::SpawnDoors [Tiles=%i, Doors=%i]"), GetSize(), DoorRequests.Num());
+
+		// Only spawn requests made since the last call, so that doors are never spawned twice.
+		for (; SpawnedRequests < DoorRequests.Num(); SpawnedRequests++)
 		{
+			const FTileDoorRequest& Request = DoorRequests[SpawnedRequests];
+
 			if (UClass* DoorClass = *Request.DoorClass)
 			{
 				// Spawn the new door into the world but do not invoke its construction script.
 				ATileDoorBase* NewDoor = World->SpawnActorDeferred<ATileDoorBase>(DoorClass, Request.DoorTransform);
 
+				// Request order is identical for every map generated from the same seed, so the
+				// request index doubles as a stable index into the replicated door states.
+				NewDoor->DoorIndex = SpawnedRequests;
+
 				// Add the new door to the owner edge if one was provided.
 				if (Request.OwnerEdge)
 				{
@@ -49,6 +101,7 @@ void FTileMapGraph::SetLive(bool bLive)
 				else
 				{
 					NewDoor->bIsSealed = true;
+					DoorSeals.Emplace(NewDoor);
 				}
 
 				// Now that the door has been sealed, finish it.
@@ -75,6 +128,10 @@ void FTileMapGraph::Empty()
 
 	// Drop the references to the old seals.
 	DoorSeals.Empty();
+
+	// Door indices restart with the next set of requests.
+	DoorRequests.Empty();
+	SpawnedRequests = 0;
 }
 
 void FTileMapGraph::GetPlans(TArray<FTilePlan>& OutTilePlans) const
@@ -87,8 +144,44 @@ void FTileMapGraph::GetPlans(TArray<FTilePlan>& OutTilePlans) const
 	}
 }
 
+int32 FTileMapGraph::FindTile(const FVector& Point, int32 HintIndex) const
+{
+	if (0 <= HintIndex && HintIndex < GetSize())
+	{
+		if (GetNodeData(HintIndex).Contains(Point))
+		{
+			return HintIndex;
+		}
+
+		// Points usually leave a tile through one of its doors, so check the neighbors next.
+		const FGraphNode& HintNode = GetNode(HintIndex);
+
+		for (int32 Edge = 0; Edge < HintNode.GetDegree(); Edge++)
+		{
+			int32 Neighbor = HintNode.GetConnectionIndex(Edge);
+
+			if (GetNodeData(Neighbor).Contains(Point))
+			{
+				return Neighbor;
+			}
+		}
+	}
+
+	for (int32 Index = 0; Index < GetSize(); Index++)
+	{
+		if (GetNodeData(Index).Contains(Point))
+		{
+			return Index;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
 void FTileMapGraph::RequestDoor(const TSubclassOf<ATileDoorBase>& DoorClass, const FTransform& DoorTransform, FTileDoor* OwnerEdge)
 {
+	LLM_SCOPE_BYTAG(IotaTile_Doors);
+
 	// Package and submit a new door request.
 	FTileDoorRequest NewRequest;
 	NewRequest.DoorClass = DoorClass;
@@ -102,3 +195,76 @@ void FTileMapGraph::RequestDoor(const TSubclassOf<ATileDoorBase>& DoorClass, con
 		SetLive();
 	}
 }
+
+void FTileMapGraph::BeginRetirement()
+{
+	LLM_SCOPE_BYTAG(IotaTile_Doors);
+
+	if (bRetiring)
+	{
+		return;
+	}
+
+	bRetiring = true;
+	bLiveGraph = false;
+
+	// Edge data is shared between mirrored edges, so clear each door pointer as it is gathered to
+	// avoid gathering it twice, and to leave nothing for the edge destructors to destroy once the
+	// graph itself is released. The new map reuses the door indices, so gathered doors give up
+	// their index before the new map can register its own doors.
+	for (int32 Index = 0; Index < GetSize(); Index++)
+	{
+		const FGraphNode& Node = GetNode(Index);
+
+		for (int32 Edge = 0; Edge < Node.GetDegree(); Edge++)
+		{
+			FTileDoor& Door = Node.GetEdgeData(Edge);
+
+			if (Door.DoorActor)
+			{
+				Door.DoorActor->ReleaseDoorIndex();
+				RetiringDoors.Emplace(Door.DoorActor);
+				Door.DoorActor = nullptr;
+			}
+		}
+	}
+
+	for (ATileDoorBase* DoorActor : DoorSeals)
+	{
+		if (DoorActor)
+		{
+			DoorActor->ReleaseDoorIndex();
+		}
+
+		RetiringDoors.Emplace(DoorActor);
+	}
+
+	DoorSeals.Empty();
+}
+
+bool FTileMapGraph::RetireDoors(double EndTime)
+{
+	LLM_SCOPE_BYTAG(IotaTile_Doors);
+
+	// Graphs normally begin retirement as they leave play, so this only gathers doors for graphs
+	// that went straight into retirement.
+	BeginRetirement();
+
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileMapGraph::RetireDoors [Doors=%i]"), RetiringDoors.Num());
+
+	do
+	{
+		if (RetiringDoors.IsEmpty())
+		{
+			break;
+		}
+
+		if (ATileDoorBase* DoorActor = RetiringDoors.Pop(false).Get())
+		{
+			DoorActor->Destroy();
+		}
+	}
+	while (FPlatformTime::Seconds() < EndTime);
+
+	return RetiringDoors.IsEmpty();
+}
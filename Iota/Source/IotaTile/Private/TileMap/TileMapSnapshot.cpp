@@ -0,0 +1,174 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#include "TileMap/TileMapSnapshot.h"
+#include "TileMap/TileMapGraph.h"
+#include "IotaTileStats.h"
+
+FTileSnapshotTile::FTileSnapshotTile(const FTilePlan& InPlan, const TArray<FTileBound>& InBounds)
+	: FTilePlan(InPlan)
+	, Bounds(InBounds)
+{
+	// Complete constructor.
+}
+
+bool FTileSnapshotTile::Contains(const FVector& Point) const
+{
+	for (const FTileBound& Bound : Bounds)
+	{
+		if (Bound.Contains(Point))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+FTileMapSnapshot::FTileMapSnapshot(int32 InMapIndex) : MapIndex(InMapIndex)
+{
+	// Complete constructor.
+}
+
+void FTileMapSnapshot::AddTile(const FTilePlan& Plan, const TArray<FTileBound>& Bounds)
+{
+	check(!bFinished);
+	Graph.MakeNode(Plan, Bounds);
+}
+
+void FTileMapSnapshot::AddDoor(int32 ChildTile, int32 ParentTile, const FTileSnapshotDoor& Door)
+{
+	check(!bFinished);
+	Graph.MakeEdge(ChildTile, ParentTile, Door);
+}
+
+void FTileMapSnapshot::AddMapGraph(const FTileMapGraph& MapGraph)
+{
+	LLM_SCOPE_BYTAG(IotaTile_Graph);
+
+	Graph.Reserve(GetNumTiles() + MapGraph.GetSize(), Graph.GetEdgeCount() + MapGraph.GetEdgeCount());
+
+	int32 BaseIndex = GetNumTiles();
+
+	for (int32 Index = 0; Index < MapGraph.GetSize(); Index++)
+	{
+		const FTileNode& TileNode = MapGraph.GetNodeData(Index);
+		AddTile(TileNode, TileNode.Bounds);
+	}
+
+	// Each door appears once from each side, so only copy it from the child side.
+	for (int32 Index = 0; Index < MapGraph.GetSize(); Index++)
+	{
+		const FTileMapGraph::FGraphNode& Node = MapGraph.GetNode(Index);
+
+		for (int32 Edge = 0; Edge < Node.GetDegree(); Edge++)
+		{
+			if (Node.GetConnectionIndex(Edge) == MapGraph.GetNodeData(Index).Parent)
+			{
+				const FTileDoor& Door = Node.GetEdgeData(Edge);
+				AddDoor(BaseIndex + Index, BaseIndex + Node.GetConnectionIndex(Edge), { Door.Portal, Door.bTerminal });
+			}
+		}
+	}
+}
+
+void FTileMapSnapshot::Finish()
+{
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileMapSnapshot::Finish [Map=%i, Tiles=%i]"), MapIndex, GetNumTiles());
+
+	// Reads build the adjacency array on demand, which is only safe while one thread is reading.
+	Graph.BuildAdjacency();
+	bFinished = true;
+}
+
+int32 FTileMapSnapshot::GetMapIndex() const
+{
+	return MapIndex;
+}
+
+int32 FTileMapSnapshot::GetNumTiles() const
+{
+	return Graph.GetSize();
+}
+
+const FTileSnapshotTile& FTileMapSnapshot::GetTile(int32 Index) const
+{
+	return Graph.GetNodeData(Index);
+}
+
+const FTileSnapshotGraph& FTileMapSnapshot::GetGraph() const
+{
+	checkf(bFinished, TEXT("Tile map snapshots must be finished before they are read."));
+	return Graph;
+}
+
+int32 FTileMapSnapshot::FindTile(const FVector& Point, int32 HintIndex) const
+{
+	if (0 <= HintIndex && HintIndex < GetNumTiles())
+	{
+		if (GetTile(HintIndex).Contains(Point))
+		{
+			return HintIndex;
+		}
+
+		const FTileSnapshotGraph::FGraphNode& HintNode = GetGraph().GetNode(HintIndex);
+
+		for (int32 Edge = 0; Edge < HintNode.GetDegree(); Edge++)
+		{
+			int32 Neighbor = HintNode.GetConnectionIndex(Edge);
+
+			if (GetTile(Neighbor).Contains(Point))
+			{
+				return Neighbor;
+			}
+		}
+	}
+
+	for (int32 Index = 0; Index < GetNumTiles(); Index++)
+	{
+		if (GetTile(Index).Contains(Point))
+		{
+			return Index;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+void FTileMapSnapshotPublisher::Publish(const TSharedPtr<const FTileMapSnapshot>& Snapshot)
+{
+	int32 Next = Epoch.GetValue() + 1;
+	FThreadSafeCounter& NextReaders = Readers[Next & 1];
+
+	// The next slot still holds the snapshot before the current one. Readers only count themselves
+	// on a slot while it is current, and the epoch moved off this slot when the current snapshot
+	// was published, so once the count drains no reader can be copying out of it.
+	while (NextReaders.GetValue() != 0)
+	{
+		FPlatformProcess::Yield();
+	}
+
+	// Dropping the old reference frees the snapshot unless a reader still holds one.
+	Slots[Next & 1] = Snapshot;
+	Epoch.Set(Next);
+}
+
+TSharedPtr<const FTileMapSnapshot> FTileMapSnapshotPublisher::Acquire() const
+{
+	for (;;)
+	{
+		int32 Current = Epoch.GetValue();
+		FThreadSafeCounter& CurrentReaders = Readers[Current & 1];
+		CurrentReaders.Increment();
+
+		// If the epoch is unchanged after counting, the writer must wait for this reader before it
+		// reuses the slot. Otherwise a snapshot was published in between, so try again.
+		if (Epoch.GetValue() == Current)
+		{
+			TSharedPtr<const FTileMapSnapshot> Snapshot = Slots[Current & 1];
+			CurrentReaders.Decrement();
+			return Snapshot;
+		}
+
+		CurrentReaders.Decrement();
+	}
+}
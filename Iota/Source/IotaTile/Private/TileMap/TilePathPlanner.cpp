@@ -0,0 +1,124 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#include "TileMap/TilePathPlanner.h"
+#include "TileMap/TileMapGraph.h"
+#include "IotaTileStats.h"
+
+void FTilePathPlanner::Reset()
+{
+	DoorGraph.Empty();
+	TileDoors.Empty();
+	Routes.Empty();
+}
+
+void FTilePathPlanner::Build(const FTileMapGraph& MapGraph)
+{
+	TILE_TRACE_SCOPE_TEXT(TEXT("TilePathPlanner::Build [Tiles=%i, Doors=%i]"), MapGraph.GetSize(), MapGraph.GetEdgeCount());
+
+	Reset();
+
+	// Door nodes share their indices with the map graph edges.
+	for (int32 Door = 0; Door < MapGraph.GetEdgeCount(); Door++)
+	{
+		DoorGraph.MakeNode(MapGraph.GetEdgeDataAt(Door).Portal.Location);
+	}
+
+	TileDoors.SetNum(MapGraph.GetSize());
+
+	for (int32 Tile = 0; Tile < MapGraph.GetSize(); Tile++)
+	{
+		const FTileMapGraph::FGraphNode& Node = MapGraph.GetNode(Tile);
+		const FTileNode& TileNode = MapGraph.GetNodeData(Tile);
+
+		TArray<int32> Portals;
+
+		// Each door fills a portal on both of its tiles. Find the one on this side.
+		for (int32 Edge = 0; Edge < Node.GetDegree(); Edge++)
+		{
+			const FTileDoor& Door = Node.GetEdgeData(Edge);
+
+			TileDoors[Tile].Add(Node.GetEdge(Edge).EdgeIndex);
+			Portals.Add(Node.GetConnectionIndex(Edge) == TileNode.Parent ? Door.ChildPortal : Door.ParentPortal);
+		}
+
+		// Join every pair of doors on the tile. Tiles exported without distances fall back on the
+		// straight-line distance, which keeps the search heuristic admissible either way.
+		for (int32 From = 0; From < TileDoors[Tile].Num(); From++)
+		{
+			for (int32 To = From + 1; To < TileDoors[Tile].Num(); To++)
+			{
+				int32 DoorA = TileDoors[Tile][From];
+				int32 DoorB = TileDoors[Tile][To];
+
+				float Straight = static_cast<float>(FVector::Distance(GetDoorLocation(DoorA), GetDoorLocation(DoorB)));
+				float Distance = TileNode.GetPortalDistance(Portals[From], Portals[To]);
+
+				DoorGraph.MakeEdge(DoorA, DoorB, FMath::Max(Distance, Straight));
+			}
+		}
+	}
+}
+
+bool FTilePathPlanner::IsEmpty() const
+{
+	return TileDoors.IsEmpty();
+}
+
+const TArray<int32>* FTilePathPlanner::FindRoute(int32 StartTile, int32 GoalTile)
+{
+	if (!TileDoors.IsValidIndex(StartTile) || !TileDoors.IsValidIndex(GoalTile))
+	{
+		return nullptr;
+	}
+
+	FIntPoint Key(StartTile, GoalTile);
+
+	if (const FTileRoute* Cached = Routes.Find(Key))
+	{
+		return Cached->bReachable ? &Cached->Doors : nullptr;
+	}
+
+	TILE_TRACE_SCOPE_TEXT(TEXT("TilePathPlanner::FindRoute [Start=%i, Goal=%i]"), StartTile, GoalTile);
+
+	FTileRoute& Route = Routes.Add(Key);
+
+	if (StartTile == GoalTile)
+	{
+		Route.bReachable = true;
+		return &Route.Doors;
+	}
+
+	const TArray<int32>& GoalDoors = TileDoors[GoalTile];
+
+	// Walking distances are never shorter than straight lines, so the straight-line distance to
+	// the nearest goal door never overestimates the remaining cost.
+	auto Heuristic = [this, &GoalDoors](int32 Door)
+	{
+		float Nearest = TNumericLimits<float>::Max();
+
+		for (int32 GoalDoor : GoalDoors)
+		{
+			Nearest = FMath::Min(Nearest, static_cast<float>(FVector::Distance(GetDoorLocation(Door), GetDoorLocation(GoalDoor))));
+		}
+
+		return Nearest;
+	};
+
+	auto Weight = [](float Distance)
+	{
+		return Distance;
+	};
+
+	Route.bReachable = DoorGraph.FindPath(TileDoors[StartTile], GoalDoors, Weight, Heuristic, Route.Doors, Scratch);
+	return Route.bReachable ? &Route.Doors : nullptr;
+}
+
+const FVector& FTilePathPlanner::GetDoorLocation(int32 Door) const
+{
+	return DoorGraph.GetNodeData(Door);
+}
+
+int32 FTilePathPlanner::GetNumCachedRoutes() const
+{
+	return Routes.Num();
+}
@@ -2,11 +2,14 @@
 
 #include "TilePlanStream.h"
 #include "TileData/TilePlan.h"
+#include "IotaTileStats.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(TilePlanStream)
 
 UTilePlanStream* UTilePlanStream::StreamInstance(UWorld* World, const FTilePlan& BasePlan, const FString& PlanName)
 {
+	LLM_SCOPE_BYTAG(IotaTile_Streams);
+
 	FTransform Transform(BasePlan.Rotation, BasePlan.Location);
 	FString PackageName = BasePlan.Level.GetLongPackageName();
 
@@ -17,5 +20,13 @@ UTilePlanStream* UTilePlanStream::StreamInstance(UWorld* World, const FTilePlan&
 	bool bSuccess = false;
 
 	ULevelStreamingDynamic* NewStream = ULevelStreamingDynamic::LoadLevelInstance(StreamParams, bSuccess);
-	return bSuccess ? Cast<UTilePlanStream>(NewStream) : nullptr;
+	UTilePlanStream* TileStream = bSuccess ? Cast<UTilePlanStream>(NewStream) : nullptr;
+
+	if (TileStream)
+	{
+		TileStream->SourcePackage = FName(PackageName);
+		TileStream->RequestTime = FPlatformTime::Seconds();
+	}
+
+	return TileStream;
 }
@@ -27,4 +27,20 @@ public:
 	 * @return Streaming handle, or null if unsuccessful.
 	 */
 	static UTilePlanStream* StreamInstance(UWorld* World, const FTilePlan& BasePlan, const FString& PlanName);
+
+	/** Index of the streamed tile within its map. */
+	int32 PlanIndex = INDEX_NONE;
+
+	/** Platform time at which the stream was requested. */
+	double RequestTime = 0;
+
+	/** Package name of the tile level, shared by every instance of the level. */
+	FName SourcePackage;
+
+	/**
+	 * Stream from a previous map with the same tile level, kept loaded until this stream finishes
+	 * loading so that the level dependencies stay resident.
+	 */
+	UPROPERTY()
+	TObjectPtr<UTilePlanStream> WarmSource;
 };
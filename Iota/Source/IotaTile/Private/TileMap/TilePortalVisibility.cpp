@@ -0,0 +1,263 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#include "TileMap/TilePortalVisibility.h"
+#include "TileMap/TileMapGraph.h"
+#include "IotaTileStats.h"
+
+/** Distance in world units within which points are treated as lying on a plane. */
+static constexpr FVector::FReal PortalTolerance = 1.0;
+
+void FTilePortalVisibility::Reset(int32 InNumTiles)
+{
+	Portals.Empty();
+	Links.Empty(InNumTiles);
+	Links.SetNum(InNumTiles);
+	VisibleSets.Empty();
+}
+
+void FTilePortalVisibility::AddPortal(int32 FromTile, int32 ToTile, const FTilePortal& Portal)
+{
+	if (!Links.IsValidIndex(FromTile) || !Links.IsValidIndex(ToTile) || FromTile == ToTile)
+	{
+		return;
+	}
+
+	FVector Normal = Portal.Direction.GetSafeNormal();
+	FVector Right = FVector::CrossProduct(FVector::UpVector, Normal).GetSafeNormal();
+
+	// Portals are vertical in practice, but fall back on a fixed axis rather than collapsing.
+	if (Right.IsNearlyZero())
+	{
+		Right = FVector::CrossProduct(FVector::ForwardVector, Normal).GetSafeNormal();
+	}
+
+	FVector Up = FVector::CrossProduct(Normal, Right);
+
+	// Plane sizes are measured in meters, and the portal location sits at the bottom center.
+	FVector HalfWidth = Right * Portal.PlaneSize.X * 50;
+	FVector Height = Up * Portal.PlaneSize.Y * 100;
+
+	FPortalQuad Quad;
+	Quad.Corners[0] = Portal.Location - HalfWidth;
+	Quad.Corners[1] = Portal.Location + HalfWidth;
+	Quad.Corners[2] = Portal.Location + HalfWidth + Height;
+	Quad.Corners[3] = Portal.Location - HalfWidth + Height;
+	Quad.Plane = FPlane(Portal.Location, Normal);
+
+	int32 PortalIndex = Portals.Emplace(Quad);
+
+	Links[FromTile].Add({ ToTile, PortalIndex, false });
+	Links[ToTile].Add({ FromTile, PortalIndex, true });
+}
+
+void FTilePortalVisibility::Build(const FTileMapGraph& MapGraph)
+{
+	Reset(MapGraph.GetSize());
+
+	for (int32 Index = 0; Index < MapGraph.GetSize(); Index++)
+	{
+		const FTileMapGraph::FGraphNode& Node = MapGraph.GetNode(Index);
+
+		// Every door joins a tile to its parent and stores the portal of the child tile, which
+		// faces out of the child. Adding doors from the child side adds each door exactly once.
+		for (int32 Edge = 0; Edge < Node.GetDegree(); Edge++)
+		{
+			int32 Neighbor = Node.GetConnectionIndex(Edge);
+
+			if (Neighbor == MapGraph.GetNodeData(Index).Parent)
+			{
+				AddPortal(Index, Neighbor, Node.GetEdgeData(Edge).Portal);
+			}
+		}
+	}
+
+	Compute();
+}
+
+void FTilePortalVisibility::Compute()
+{
+	TILE_TRACE_SCOPE_TEXT(TEXT("TilePortalVisibility::Compute [Tiles=%i, Portals=%i]"), Links.Num(), Portals.Num());
+
+	VisibleSets.Empty(Links.Num());
+
+	TArray<int32> Path;
+	TArray<FPlane> NoPlanes;
+
+	for (int32 Source = 0; Source < Links.Num(); Source++)
+	{
+		TBitArray<>& VisibleSet = VisibleSets.Emplace_GetRef(false, Links.Num());
+		VisibleSet[Source] = true;
+
+		// Any point in the source tile can look through its own portals at any angle, so each
+		// neighbor is visible and starts a chain of its own.
+		for (const FPortalLink& Link : Links[Source])
+		{
+			VisibleSet[Link.Tile] = true;
+
+			FPortalQuad First = GetQuad(Link);
+
+			Path.Reset();
+			Path.Add(Source);
+			Path.Add(Link.Tile);
+
+			ComputeChain(Source, Link.Tile, First, First, NoPlanes, Path);
+		}
+	}
+}
+
+bool FTilePortalVisibility::IsEmpty() const
+{
+	return VisibleSets.IsEmpty();
+}
+
+int32 FTilePortalVisibility::GetNumTiles() const
+{
+	return VisibleSets.Num();
+}
+
+bool FTilePortalVisibility::IsVisible(int32 FromTile, int32 ToTile) const
+{
+	if (!VisibleSets.IsValidIndex(FromTile) || ToTile < 0 || VisibleSets[FromTile].Num() <= ToTile)
+	{
+		return true;
+	}
+
+	return VisibleSets[FromTile][ToTile];
+}
+
+void FTilePortalVisibility::ComputeChain(int32 Source, int32 Tile, const FPortalQuad& First, const FPortalQuad& Last, const TArray<FPlane>& Planes, TArray<int32>& Path)
+{
+	for (const FPortalLink& Link : Links[Tile])
+	{
+		if (Path.Contains(Link.Tile))
+		{
+			continue;
+		}
+
+		FPortalQuad Next = GetQuad(Link);
+
+		// The next portal must lie past both ends of the chain, and inside the volume of lines
+		// that pass through both of them.
+		if (!IsInFront(Next, First.Plane) || !IsInFront(Next, Last.Plane) || !PassesPlanes(Next, Planes))
+		{
+			continue;
+		}
+
+		VisibleSets[Source][Link.Tile] = true;
+
+		TArray<FPlane> NextPlanes;
+		FindSeparatingPlanes(First, Next, NextPlanes);
+
+		Path.Push(Link.Tile);
+		ComputeChain(Source, Link.Tile, First, Next, NextPlanes, Path);
+		Path.Pop(false);
+	}
+}
+
+FTilePortalVisibility::FPortalQuad FTilePortalVisibility::FPortalQuad::Reversed() const
+{
+	FPortalQuad Quad = *this;
+	Quad.Plane = Plane.Flip();
+	return Quad;
+}
+
+FTilePortalVisibility::FPortalQuad FTilePortalVisibility::GetQuad(const FPortalLink& Link) const
+{
+	return Link.bReverse ? Portals[Link.Portal].Reversed() : Portals[Link.Portal];
+}
+
+bool FTilePortalVisibility::IsInFront(const FPortalQuad& Quad, const FPlane& Plane)
+{
+	for (const FVector& Corner : Quad.Corners)
+	{
+		if (PortalTolerance < Plane.PlaneDot(Corner))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FTilePortalVisibility::PassesPlanes(const FPortalQuad& Quad, const TArray<FPlane>& Planes)
+{
+	for (const FPlane& Plane : Planes)
+	{
+		bool bAnyInFront = false;
+
+		for (const FVector& Corner : Quad.Corners)
+		{
+			if (-PortalTolerance <= Plane.PlaneDot(Corner))
+			{
+				bAnyInFront = true;
+				break;
+			}
+		}
+
+		if (!bAnyInFront)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void FTilePortalVisibility::FindSeparatingPlanes(const FPortalQuad& A, const FPortalQuad& B, TArray<FPlane>& OutPlanes)
+{
+	// Test planes through each edge of one rectangle and each corner of the other, in both
+	// directions. A plane separates the rectangles if they lie on opposite sides of it.
+	for (int32 Pass = 0; Pass < 2; Pass++)
+	{
+		const FPortalQuad& EdgeQuad = Pass == 0 ? A : B;
+		const FPortalQuad& CornerQuad = Pass == 0 ? B : A;
+
+		for (int32 Edge = 0; Edge < 4; Edge++)
+		{
+			const FVector& Start = EdgeQuad.Corners[Edge];
+			const FVector& End = EdgeQuad.Corners[(Edge + 1) % 4];
+
+			for (const FVector& Corner : CornerQuad.Corners)
+			{
+				FVector Normal = FVector::CrossProduct(End - Start, Corner - Start);
+
+				if (!Normal.Normalize())
+				{
+					continue;
+				}
+
+				FPlane Plane(Start, Normal);
+
+				bool bEdgeBehind = true;
+				bool bEdgeInFront = true;
+				bool bCornerBehind = true;
+				bool bCornerInFront = true;
+
+				for (int32 Index = 0; Index < 4; Index++)
+				{
+					FVector::FReal EdgeDot = Plane.PlaneDot(EdgeQuad.Corners[Index]);
+					FVector::FReal CornerDot = Plane.PlaneDot(CornerQuad.Corners[Index]);
+
+					bEdgeBehind &= EdgeDot <= PortalTolerance;
+					bEdgeInFront &= -PortalTolerance <= EdgeDot;
+					bCornerBehind &= CornerDot <= PortalTolerance;
+					bCornerInFront &= -PortalTolerance <= CornerDot;
+				}
+
+				// Orient the plane so that the edge rectangle is behind it and the corner rectangle
+				// is in front. Planes that cut through either rectangle do not separate them.
+				if (bEdgeInFront && bCornerBehind && !(bEdgeBehind && bCornerInFront))
+				{
+					Plane = Plane.Flip();
+				}
+				else if (!(bEdgeBehind && bCornerInFront))
+				{
+					continue;
+				}
+
+				// Output planes always face the second rectangle.
+				OutPlanes.Add(Pass == 0 ? Plane : Plane.Flip());
+			}
+		}
+	}
+}
@@ -0,0 +1,65 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#include "TileMap/TileProxyActor.h"
+#include "TileData/TileBound.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInterface.h"
+#include "UObject/ConstructorHelpers.h"
+#include "IotaTileStats.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(TileProxyActor)
+
+ATileProxyActor::ATileProxyActor()
+{
+	SetCanBeDamaged(false);
+	SetReplicates(false);
+
+	PrimaryActorTick.bCanEverTick = false;
+
+	struct FConstructorStatics
+	{
+		ConstructorHelpers::FObjectFinderOptional<UStaticMesh> BoxMesh;
+		ConstructorHelpers::FObjectFinderOptional<UMaterialInterface> BoxMaterial;
+
+		FConstructorStatics()
+			: BoxMesh(TEXT("/Engine/BasicShapes/Cube"))
+			, BoxMaterial(TEXT("/Engine/BasicShapes/BasicShapeMaterial"))
+		{
+			// Default constructor.
+		}
+	};
+
+	static FConstructorStatics ConstructorStatics;
+
+	// Proxies are purely visual, so they neither collide nor cast shadows. Instances change as
+	// players move, so the component is movable.
+	BoxComponent = CreateDefaultSubobject<UInstancedStaticMeshComponent>("ProxyBoxes");
+	BoxComponent->SetStaticMesh(ConstructorStatics.BoxMesh.Get());
+	BoxComponent->SetMaterial(0, ConstructorStatics.BoxMaterial.Get());
+	BoxComponent->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	BoxComponent->SetCanEverAffectNavigation(false);
+	BoxComponent->CastShadow = false;
+	BoxComponent->Mobility = EComponentMobility::Movable;
+
+	RootComponent = BoxComponent;
+}
+
+void ATileProxyActor::SetBounds(const TArray<const FTileBound*>& Bounds)
+{
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileProxyActor::SetBounds [Bounds=%i]"), Bounds.Num());
+	LLM_SCOPE_BYTAG(IotaTile_Streams);
+
+	TArray<FTransform> Transforms;
+	Transforms.Reserve(Bounds.Num());
+
+	// The engine cube is 100 units across, so scale it by the extent over its own half size.
+	for (const FTileBound* Bound : Bounds)
+	{
+		Transforms.Emplace(Bound->Rotation, Bound->Center, Bound->Extent / 50);
+	}
+
+	BoxComponent->ClearInstances();
+	BoxComponent->AddInstances(Transforms, false, true);
+}
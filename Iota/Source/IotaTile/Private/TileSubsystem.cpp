@@ -5,13 +5,102 @@
 #include "TileGen/TileGenAction.h"
 #include "TileGen/TileGraphPlan.h"
 #include "TileMap/TileDoorBase.h"
+#include "TileMap/TileMapComponent.h"
 #include "TileMap/TileMapGraph.h"
+#include "TileMap/TileMapSnapshot.h"
+#include "TileMap/TilePathPlanner.h"
 #include "TileMap/TilePlanStream.h"
+#include "TileMap/TilePortalVisibility.h"
+#include "TileMap/TileProxyActor.h"
 #include "IotaCore/ActorTable.h"
+#include "Engine/LevelBounds.h"
 #include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "NavigationSystem.h"
+#include "NavigationPath.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "IotaTileLog.h"
+#include "IotaTileStats.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(TileSubsystem)
 
+CSV_DEFINE_CATEGORY(IotaTile, true);
+
+/** Distance in world units a local player must move before the focus tiles are found again. */
+static constexpr double FocusViewTolerance = 50.0;
+
+static TAutoConsoleVariable<int32> CVarTileMaxConcurrentLoads(
+	TEXT("IotaTile.MaxConcurrentLoads"),
+	4,
+	TEXT("Maximum number of tile levels loading at once. Queued tiles nearest the local player start first. ")
+	TEXT("Zero or less streams every tile at once."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<bool> CVarTileWarmStreams(
+	TEXT("IotaTile.WarmStreams"),
+	true,
+	TEXT("If true, loaded tile levels from the previous map stay loaded until the new map has loaded its own ")
+	TEXT("instance of the same level, so that shared level dependencies are not reloaded from disk."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarTileRetireBudget(
+	TEXT("IotaTile.RetireBudgetMs"),
+	1.0f,
+	TEXT("Time in milliseconds that may be spent each frame destroying doors from retired tile maps. ")
+	TEXT("Zero or less destroys every retiring door in a single frame."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarTileMaxConcurrentUnloads(
+	TEXT("IotaTile.MaxConcurrentUnloads"),
+	2,
+	TEXT("Maximum number of retired tile levels unloading at once. Another level starts unloading only once an earlier one has left the world. ")
+	TEXT("Zero or less unloads every retired level at once."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarTilePortalCulling(
+	TEXT("IotaTile.PortalCulling"),
+	1,
+	TEXT("Hides tile levels that cannot be seen through portals from any local player tile. ")
+	TEXT("0 disables culling, 1 culls on network clients only, and 2 also culls on servers and standalone games. ")
+	TEXT("Hidden levels lose their collision, so culling on the authority can affect simulated actors."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<bool> CVarTileProxies(
+	TEXT("IotaTile.TileProxies"),
+	true,
+	TEXT("If true, tiles whose levels are not visible are drawn as boxes built from their collision bounds, ")
+	TEXT("unless portal culling hides them. Combined with IotaTile.EvictDistance, distant tiles swap to their proxies."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarTileReadyDistance(
+	TEXT("IotaTile.ReadyDistance"),
+	-1,
+	TEXT("Number of doors from a focus tile within which tiles must be usable before the live tile map is ready. ")
+	TEXT("Negative requires every tile in the map, as does a map with no focus tile."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarTileEvictDistance(
+	TEXT("IotaTile.EvictDistance"),
+	0,
+	TEXT("Clients unload tile levels more than this many doors from every local player. ")
+	TEXT("Zero or less keeps every tile loaded."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarTileReloadDistance(
+	TEXT("IotaTile.ReloadDistance"),
+	2,
+	TEXT("Clients reload evicted tile levels within this many doors of a local player. ")
+	TEXT("Clamped below IotaTile.EvictDistance so that tiles in between keep their state."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarTileMemoryBudget(
+	TEXT("IotaTile.MemoryBudgetMB"),
+	0,
+	TEXT("While client physical memory use exceeds this many megabytes, tiles beyond IotaTile.ReloadDistance ")
+	TEXT("are evicted farthest first. Zero or less disables the budget. Requires IotaTile.EvictDistance."),
+	ECVF_Default);
+
 bool UTileSubsystem::CanGenerate() const
 {
 	return GetWorld()->GetNetMode() < NM_Client;
@@ -21,54 +110,130 @@ void UTileSubsystem::MakeNewTileMap(const FTileGenParams& Parameters, const FGen
 {
 	if (CanGenerate())
 	{
-		FSimpleDelegate Callback = FSimpleDelegate::CreateUObject(this, &UTileSubsystem::NotifyGeneratorComplete);
+		StartGenerator(Parameters, OnComplete);
 
-		// Create a new generation action and store the provided delegate as a member. Doing so
-		// automatically destroys the previous action instance and dumps its resources.
-		GeneratorAction = MakeShared<FTileGenAction>(Parameters, Callback);
-		OnGeneratorComplete = OnComplete;
+		// Keep the live map graph (and its doors) around until the new map goes live, then retire
+		// it over several frames. A graph that never went live has spawned no doors, so it can be
+		// released immediately.
+		if (MapGraph.IsValid() && MapGraph->IsLive())
+		{
+			RetirePreviousGraph();
+			PreviousGraph = MapGraph;
+		}
 
-		// Create a new tile map graph and pass in the subsystem world context. Doing so also 
-		// automatically destroys the previous map graph and destroys all actors stored on it.
+		// Create a new tile map graph and pass in the subsystem world context.
+		LLM_SCOPE_BYTAG(IotaTile_Graph);
 		MapGraph = MakeShared<FTileMapGraph>(GetWorld());
 	}
 }
 
+void UTileSubsystem::StartGenerator(const FTileGenParams& Parameters, const FGeneratorDelegate& OnComplete, int32 BudgetCutoff)
+{
+	FSimpleDelegate Callback = FSimpleDelegate::CreateUObject(this, &UTileSubsystem::NotifyGeneratorComplete);
+
+	// Create a new generation action and store the provided delegate as a member. Doing so
+	// automatically destroys the previous action instance and dumps its resources.
+	GeneratorAction = MakeShared<FTileGenAction>(Parameters, Callback, BudgetCutoff);
+	OnGeneratorComplete = OnComplete;
+	PendingSeed.Reset();
+
+	// Streams pipelined by the previous action belong to a map that will never go live.
+	ReleasePipelineStreams();
+	PipelineBase = FMath::Max(MapCount, ActiveIndex);
+}
+
 void UTileSubsystem::NotifyGeneratorComplete()
 {
 	if (GeneratorAction.IsValid())
 	{
+		// Every plan is committed before the worker exits, so stream any the tick has not seen.
+		UpdatePipeline();
+
+		// Any map about to be streamed should finish prefetching its own levels first.
+		if (GeneratorAction->IsMapValid())
+		{
+			GeneratorAction->PrioritizeLevels();
+		}
+
+		// Maps regenerated from a server seed are streamed rather than stored in the map graph.
+		if (PendingSeed.IsSet() && GeneratorAction->IsMapValid())
+		{
+			NotifySeedComplete();
+		}
+
 		// If the generated tile map is valid and contains a complete core tile sequence then it
 		// can be loaded into the subsystem map graph.
-		if (GeneratorAction->IsMapValid())
+		else if (GeneratorAction->IsMapValid())
 		{
-			// Increment the map counter.
-			MapCount++;
+			// Increment the map counter. Pipelined maps have already named their streams after the
+			// epoch that produced them, so the counter skips ahead to match.
+			MapCount = IsPipelining() ? PipelineBase + GeneratorAction->GetEpoch() : MapCount + 1;
+
+			if (GeneratorAction->GetQuality() == ETileGenQuality::BestEffort)
+			{
+				UE_LOG(LogIotaTile, Warning, TEXT("Generation budget exceeded; using a best-effort map with %i of %i core tiles."), GeneratorAction->GetCoreLength(), GeneratorAction->Params.Length);
+			}
+
+			TILE_TRACE_SCOPE_TEXT(TEXT("TileSubsystem::BuildMapGraph [Map=%i, Tiles=%i]"), MapCount, GeneratorAction->GetTileMap()->Num());
+			LLM_SCOPE_BYTAG(IotaTile_Graph);
+
+			// Record the seed for the new map so that it can be replicated to clients.
+			LastSeed.Params = GeneratorAction->Params;
+			LastSeed.TilesetHash = static_cast<int32>(GeneratorAction->GetTilesetHash());
+			LastSeed.MapHash = static_cast<int32>(GeneratorAction->GetMapHash());
+			LastSeed.BudgetCutoff = GeneratorAction->GetBudgetCutoff();
+			LastSeed.MapIndex = MapCount;
+
+			// Select doors with a stream seeded by the map parameters rather than the global
+			// random generator, so that the same seed always produces the same doors.
+			FRandomStream DoorStream(GeneratorAction->Params.Seed);
 
 			// Collect all door subtypes that belong to the tileset and store them in a table.
 			// For each door added, use its door size as its key for the table.
-			TActorTable<FIntPoint, ATileDoorBase> DoorTable(GeneratorAction->Params.Tileset, [](ATileDoorBase* AssetObject)
+			TActorTable<FIntPoint, ATileDoorBase> DoorTable;
+
 			{
-				return AssetObject->DoorSize;
-			});
+				TILE_TRACE_SCOPE_TEXT(TEXT("TileSubsystem::CollectDoorTable [Map=%i]"), MapCount);
+
+				DoorTable.CollectWithCategory(GeneratorAction->Params.Tileset, [](ATileDoorBase* AssetObject)
+				{
+					return AssetObject->DoorSize;
+				});
+			}
 
 			// Populate the map graph. Each graph plan can be converted into a graph node using the
 			// base tile plan to fill the node data. One edge can also be added for each graph plan
 			// parent connection.
-			for (const FTileGraphPlan& GraphPlan : *GeneratorAction->GetTileMap())
+			const TArray<FTileGraphPlan>& GraphPlans = *GeneratorAction->GetTileMap();
+			MapGraph->Reserve(GraphPlans.Num(), GraphPlans.Num());
+
+			for (const FTileGraphPlan& GraphPlan : GraphPlans)
 			{
-				int32 NewNode = MapGraph->MakeNode(GraphPlan);
+				int32 NewNode = MapGraph->MakeNode(GraphPlan, GraphPlan.Bounds, GraphPlan.PortalDistances, GraphPlan.NumTemplatePortals);
 
 				if (0 <= GraphPlan.GetConnection())
 				{
 					FTileDoor& NewDoor = MapGraph->MakeEdge(NewNode, GraphPlan.GetConnection());
 
-					// If the current graph plan index exceeds the parameter length, then the plan
-					// must represent a terminal tile.
-					NewDoor.bTerminal = GeneratorAction->Params.Length <= NewNode;
+					// If the current graph plan index exceeds the core length, then the plan must
+					// represent a terminal tile.
+					NewDoor.bTerminal = GeneratorAction->GetCoreLength() <= NewNode;
 
 					// Isolate the first portal on the plan for easy access.
 					const FTileGraphPortal& Portal = *GraphPlan.Portals.GetData();
+					NewDoor.Portal = Portal;
+					NewDoor.ChildPortal = Portal.TemplateIndex;
+
+					// Find the matching portal on the parent, so that paths can cost the door from
+					// either side.
+					for (const FTileGraphPortal& ParentPortal : GraphPlans[GraphPlan.GetConnection()].Portals)
+					{
+						if (ParentPortal.ConnectionIndex == NewNode)
+						{
+							NewDoor.ParentPortal = ParentPortal.TemplateIndex;
+							break;
+						}
+					}
 
 					// Calculate the door transform from the portal values.
 					FRotator Rotation = FRotationMatrix::MakeFromX(Portal.Direction).Rotator();
@@ -76,7 +241,7 @@ void UTileSubsystem::NotifyGeneratorComplete()
 
 					// Spawn a new door, using the table to select a size-appropriate door class
 					// Also pass in the calculated door transform and edge data address.
-					MapGraph->RequestDoor(DoorTable.GetRandomSubtype(Portal.PlaneSize), DoorTransform, &NewDoor);
+					MapGraph->RequestDoor(DoorTable.GetRandomSubtype(Portal.PlaneSize, DoorStream), DoorTransform, &NewDoor);
 				}
 
 				// Vacant portals represent holes in level geometry, so they need to be filled.
@@ -93,27 +258,115 @@ void UTileSubsystem::NotifyGeneratorComplete()
 
 						// Spawn a new door, using the table to select a size-appropriate door class
 						// Also pass in the calculated door transform.
-						MapGraph->RequestDoor(DoorTable.GetRandomSubtype(Portal.PlaneSize), DoorTransform);
+						MapGraph->RequestDoor(DoorTable.GetRandomSubtype(Portal.PlaneSize, DoorStream), DoorTransform);
 					}
 				}
 			}
 
 			// Trigger the callback delegate once the map is stored.
-			if (OnGeneratorComplete.IsBound())
-			{
-				OnGeneratorComplete.Execute();
-			}
+			OnGeneratorComplete.ExecuteIfBound(true);
+		}
+
+		// If the tileset cannot produce a valid map under the parameters, or the generation budget
+		// ran out without a usable best-effort map, regenerating would never succeed. Report the
+		// problem and release the action instead of retrying endlessly.
+		else if (GeneratorAction->GetReport().IsInfeasible() || GeneratorAction->GetReport().Failure == ETileGenFailure::OverBudget)
+		{
+			AbandonGenerator();
 		}
 
 		// If the generated tile map is not valid, regenerate it and wait for the next completion.
 		// Keep regenerating until a valid map is generated.
 		else
 		{
+			UE_LOG(LogIotaTile, Verbose, TEXT("%s"), *GeneratorAction->GetReport().ToString());
 			GeneratorAction->Regenerate();
 		}
 	}
 }
 
+void UTileSubsystem::NotifySeedComplete()
+{
+	FTileMapSeed Seed = PendingSeed.GetValue();
+	PendingSeed.Reset();
+
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileSubsystem::VerifySeededMap [Map=%i]"), Seed.MapIndex);
+
+	// A mismatched tileset hash means the client has different tile data than the server, which
+	// is the most likely cause of a mismatched map hash, so check it first.
+	if (GeneratorAction->GetTilesetHash() != static_cast<uint32>(Seed.TilesetHash))
+	{
+		UE_LOG(LogIotaTile, Error, TEXT("Seeded map %i rejected: the local tileset does not match the server tileset."), Seed.MapIndex);
+		OnGeneratorComplete.ExecuteIfBound(false);
+		return;
+	}
+
+	if (GeneratorAction->GetMapHash() != static_cast<uint32>(Seed.MapHash))
+	{
+		UE_LOG(LogIotaTile, Error, TEXT("Seeded map %i rejected: the regenerated map does not match the server map."), Seed.MapIndex);
+		OnGeneratorComplete.ExecuteIfBound(false);
+		return;
+	}
+
+	TArray<FTilePlan> TileMap;
+	TileMap.Reserve(GeneratorAction->GetTileMap()->Num());
+
+	for (const FTileGraphPlan& GraphPlan : *GeneratorAction->GetTileMap())
+	{
+		TileMap.Emplace(GraphPlan);
+	}
+
+	SetLiveTileMap(TileMap, Seed.MapIndex);
+
+	// The regenerated map carries its portals, so clients can cull tiles without a map graph.
+	if (ActiveIndex == Seed.MapIndex)
+	{
+		const TArray<FTileGraphPlan>& GraphPlans = *GeneratorAction->GetTileMap();
+		PortalVisibility->Reset(GraphPlans.Num());
+
+		for (int32 PlanIndex = 0; PlanIndex < GraphPlans.Num(); PlanIndex++)
+		{
+			const FTileGraphPlan& GraphPlan = GraphPlans[PlanIndex];
+			FTileSnapshotDoor& Door = TileDoors.AddDefaulted_GetRef();
+
+			if (0 <= GraphPlan.GetConnection())
+			{
+				Door.Portal = *GraphPlan.Portals.GetData();
+				Door.bTerminal = GeneratorAction->GetCoreLength() <= PlanIndex;
+				PortalVisibility->AddPortal(PlanIndex, GraphPlan.GetConnection(), Door.Portal);
+			}
+
+			TileBounds.Add(GraphPlan.Bounds);
+		}
+
+		PortalVisibility->Compute();
+
+		// Republish the snapshot now that the bounds and portals are known.
+		PublishMapSnapshot();
+	}
+
+	// Trigger the callback delegate once the map is streaming.
+	OnGeneratorComplete.ExecuteIfBound(true);
+}
+
+void UTileSubsystem::AbandonGenerator()
+{
+	UE_LOG(LogIotaTile, Error, TEXT("%s"), *GeneratorAction->GetReport().ToString());
+	GeneratorAction.Reset();
+	PendingSeed.Reset();
+	ReleasePipelineStreams();
+
+	// The new map will never go live, so the map it replaced stays active. Its doors were never
+	// retired, so it can simply take the place of the empty graph again.
+	if (PreviousGraph.IsValid())
+	{
+		MapGraph = PreviousGraph;
+		PreviousGraph.Reset();
+	}
+
+	OnGeneratorComplete.ExecuteIfBound(false);
+}
+
 void UTileSubsystem::GetGraphTileMap(TArray<FTilePlan>& OutTileMap, int32& OutMapIndex) const
 {
 	OutTileMap.Empty();
@@ -126,45 +379,1272 @@ void UTileSubsystem::GetGraphTileMap(TArray<FTilePlan>& OutTileMap, int32& OutMa
 	}
 }
 
+void UTileSubsystem::GetPackedTileMap(FTileMapPack& OutPack) const
+{
+	OutPack = FTileMapPack();
+
+	if (MapGraph.IsValid() && !MapGraph->IsEmpty())
+	{
+		MapGraph->GetPlans(OutPack.Plans);
+
+		// Plans are quantized relative to the map origin, so pack them in the generator frame.
+		OutPack.Origin = LastSeed.Params.Location;
+		OutPack.OriginYaw = LastSeed.Params.Rotation.Yaw;
+		OutPack.GridSize = LastSeed.Params.GridSize;
+		OutPack.MapIndex = MapCount;
+	}
+}
+
+void UTileSubsystem::SetPackedTileMap(const FTileMapPack& Pack)
+{
+	SetLiveTileMap(Pack.Plans, Pack.MapIndex);
+}
+
+void UTileSubsystem::GetSeededTileMap(FTileMapSeed& OutSeed) const
+{
+	OutSeed = FTileMapSeed();
+
+	if (MapGraph.IsValid() && !MapGraph->IsEmpty())
+	{
+		OutSeed = LastSeed;
+	}
+}
+
+void UTileSubsystem::SetSeededTileMap(const FTileMapSeed& Seed, const FGeneratorDelegate& OnComplete)
+{
+	// Servers already hold the tile map the seed describes, and stale seeds would discard the
+	// active map once regenerated, so only regenerate new seeds on clients.
+	if (CanGenerate() || !Seed.IsValid() || Seed.MapIndex <= ActiveIndex)
+	{
+		return;
+	}
+
+	// Replay the generator from the original seed. Any regeneration attempts made on the server
+	// will be made again here in the same order, so the resulting map should match exactly.
+	StartGenerator(Seed.Params, OnComplete, Seed.BudgetCutoff);
+	PendingSeed = Seed;
+}
+
 void UTileSubsystem::SetLiveTileMap(const TArray<FTilePlan>& NewTileMap, int32 MapIndex)
+{
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileSubsystem::SetLiveTileMap [Map=%i, Tiles=%i]"), MapIndex, NewTileMap.Num());
+
+	if (!BeginLiveTileMap(MapIndex, NewTileMap.Num()))
+	{
+		return;
+	}
+
+	for (int32 PlanIndex = 0; PlanIndex < NewTileMap.Num(); PlanIndex++)
+	{
+		AddLiveTile(NewTileMap[PlanIndex], MapIndex, PlanIndex);
+	}
+
+	// If the subsystem is running on a server and has a valid map graph stored within itself, then
+	// mark the map graph as live to spawn in additional actors (such as doors).
+	if (CanGenerate() && MapGraph.IsValid() && !MapGraph->IsEmpty())
+	{
+		MapGraph->SetLive();
+		PortalVisibility->Build(*MapGraph);
+		PathPlanner->Build(*MapGraph);
+
+		for (int32 Index = 0; Index < MapGraph->GetSize(); Index++)
+		{
+			TileBounds.Add(MapGraph->GetNodeData(Index).Bounds);
+		}
+	}
+
+	// The map now streams its own levels, so the rest of the prefetched tileset can be collected.
+	if (GeneratorAction.IsValid() && GeneratorAction->CanAccess())
+	{
+		GeneratorAction->ReleasePrefetch();
+	}
+
+	// Publish the new map for readers on other threads.
+	PublishMapSnapshot();
+}
+
+bool UTileSubsystem::BeginLiveTileMap(int32 MapIndex, int32 ExpectedTiles)
 {
 	// Ensure that the map index exceeds the active index. Doing so guarantees that each new map
 	// index is always unique and thus eliminates the risk of name overlaps.
 	if (MapIndex <= ActiveIndex)
 	{
-		return;
+		return false;
 	}
 
+	LLM_SCOPE_BYTAG(IotaTile_Streams);
+
 	// Update the active index.
 	ActiveIndex = MapIndex;
 
-	// Mark the active tile map as requesting an unload and removal. Doing so is asynchronous, so
-	// the active map will remain in-world when the new map begins its load.
+	// The previous map is no longer in play, so its doors can start coming down.
+	RetirePreviousGraph();
+
+	// Streams retained from an even older map can no longer be matched, so release them now.
+	ReleaseRetainedStreams();
+
+	// Retire the active tile map. Its streams are unloaded a few at a time under the retirement
+	// budget, so the active map will remain in-world when the new map begins its load. Loaded
+	// streams can instead be retained until the new map has loaded its own instance of the same
+	// level, which keeps the level dependencies (meshes, materials, and so on) resident.
+	bool bRetain = CVarTileWarmStreams.GetValueOnGameThread();
+
 	for (UTilePlanStream* Stream : ActiveStreams)
 	{
-		Stream->SetIsRequestingUnloadAndRemoval(true);
+		if (Stream->WarmSource)
+		{
+			RetireStream(Stream->WarmSource);
+			Stream->WarmSource = nullptr;
+		}
+
+		if (bRetain && Stream->IsLevelLoaded())
+		{
+			RetainedStreams.Emplace(Stream);
+		}
+		else
+		{
+			RetireStream(Stream);
+		}
 	}
 
 	// Empty and reserve the active array.
-	ActiveStreams.Empty(NewTileMap.Num());
+	ActiveStreams.Empty(ExpectedTiles);
 
-	for (int32 PlanIndex = 0; PlanIndex < NewTileMap.Num(); PlanIndex++)
+	// Streams pipelined under any other map index can never be adopted.
+	if (MapIndex != PipelineIndex)
+	{
+		ReleasePipelineStreams();
+	}
+
+	// Drop any tiles from the old map that have not started streaming yet.
+	PendingTiles.Empty(ExpectedTiles);
+	TileParents.Empty(ExpectedTiles);
+	TilePlans.Empty(ExpectedTiles);
+	TileLocations.Empty(ExpectedTiles);
+	TileDistances.Empty(ExpectedTiles);
+	TileBoxes.Empty(ExpectedTiles);
+	FocusTiles.Empty();
+	FocusViewLocations.Empty();
+
+	// Visibility is rebuilt for the new map once its portals are known.
+	if (!PortalVisibility.IsValid())
+	{
+		PortalVisibility = MakeShared<FTilePortalVisibility>();
+	}
+
+	PortalVisibility->Reset();
+
+	// Cached routes belong to the old map.
+	if (!PathPlanner.IsValid())
+	{
+		PathPlanner = MakeShared<FTilePathPlanner>();
+	}
+
+	PathPlanner->Reset();
+	TileBounds.Empty(ExpectedTiles);
+	TileDoors.Empty(ExpectedTiles);
+	TileTimings.Empty(ExpectedTiles);
+
+	// Readers must not keep seeing the old map while the new one arrives.
+	GetSnapshotPublisher()->Publish(nullptr);
+	ArrivedTileCount = 0;
+	bSnapshotDirty = false;
+
+	// Readiness starts over with the new map.
+	MapStartTime = FPlatformTime::Seconds();
+	ExpectedTileCount = ExpectedTiles;
+	bMapReady = false;
+
+	return true;
+}
+
+void UTileSubsystem::ExpectLiveTiles(int32 MapIndex, int32 ExpectedTiles)
+{
+	if (MapIndex == ActiveIndex)
+	{
+		ExpectedTileCount = FMath::Max(ExpectedTileCount, ExpectedTiles);
+	}
+}
+
+void UTileSubsystem::AddLiveTile(const FTilePlan& TilePlan, int32 MapIndex, int32 PlanIndex)
+{
+	// Tiles can only be added to the active map.
+	if (MapIndex != ActiveIndex)
+	{
+		return;
+	}
+
+	LLM_SCOPE_BYTAG(IotaTile_Streams);
+
+	// Record the tile in the streaming graph. Plans can arrive out of order over the network, so
+	// grow the arrays to fit rather than assuming the plans are contiguous.
+	while (TileParents.Num() <= PlanIndex)
+	{
+		TileParents.Add(INDEX_NONE);
+		TilePlans.AddDefaulted();
+		TileLocations.Emplace();
+		TileTimings.AddDefaulted();
+	}
+
+	if (!TileLocations[PlanIndex].IsSet())
+	{
+		ArrivedTileCount++;
+	}
+
+	TileTimings[PlanIndex].QueueTime = FPlatformTime::Seconds();
+
+	TileParents[PlanIndex] = TilePlan.Parent;
+	TilePlans[PlanIndex] = TilePlan;
+	bSnapshotDirty = true;
+	TileLocations[PlanIndex] = TilePlan.Location;
+	bDistancesDirty = true;
+
+	// Tiles pipelined during generation are already streaming, so they skip the queue.
+	if (AdoptPipelineStream(PlanIndex))
+	{
+		return;
+	}
+
+	// Queue the tile. It will start streaming on the next tick, in order of distance.
+	PendingTiles.Add({ TilePlan, PlanIndex });
+}
+
+void UTileSubsystem::StreamTile(const FTilePlan& TilePlan, int32 PlanIndex)
+{
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileSubsystem::StreamInstance [Map=%i, Tile=%i]"), ActiveIndex, PlanIndex);
+	LLM_SCOPE_BYTAG(IotaTile_Streams);
+
+	// Generate a unique identifier using the subsystem counter and the plan index. The counter
+	// ensures that there will be no conflicts between the active map and the new map.
+	FString PlanName = FString::Printf(TEXT("Tile_%i_%i"), ActiveIndex, PlanIndex);
+
+	// Attempt to stream in the new tile level and track it if successful.
+	if (UTilePlanStream* NewStream = UTilePlanStream::StreamInstance(GetWorld(), TilePlan, PlanName))
 	{
-		// Generate a unique identifier using the subsystem counter and the plan index. The counter
-		// ensures that there will be no conflicts between the active map and the new map.
-		FString PlanName = FString::Printf(TEXT("Tile_%i_%i"), MapIndex, PlanIndex);
+		// Nearer tiles load first. Unreachable tiles keep the lowest priority.
+		int32 Distance = GetTileDistance(PlanIndex);
+		NewStream->PlanIndex = PlanIndex;
+		NewStream->SetPriority(Distance == MAX_int32 ? MIN_int32 : -Distance);
 
-		// Attempt to stream in the new tile level and track it if successful.
-		if (UTilePlanStream* NewStream = UTilePlanStream::StreamInstance(GetWorld(), NewTileMap[PlanIndex], PlanName))
+		// If the old map had this level loaded, hold on to that instance until the new one loads.
+		int32 RetainedIndex = RetainedStreams.IndexOfByPredicate([NewStream](const UTilePlanStream* Stream)
 		{
-			ActiveStreams.Emplace(NewStream);
+			return Stream->SourcePackage == NewStream->SourcePackage;
+		});
+
+		if (RetainedIndex != INDEX_NONE)
+		{
+			NewStream->WarmSource = RetainedStreams[RetainedIndex];
+			RetainedStreams.RemoveAtSwap(RetainedIndex);
 		}
+
+		ActiveStreams.Emplace(NewStream);
+		bBoundsPending = true;
 	}
+}
 
-	// If the subsystem is running on a server and has a valid map graph stored within itself, then
-	// mark the map graph as live to spawn in additional actors (such as doors).
-	if (CanGenerate() && MapGraph.IsValid() && !MapGraph->IsEmpty())
+void UTileSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	UpdatePipeline();
+	UpdateRetirement();
+
+	// Publish the map once every expected tile has arrived, and again whenever tiles are appended.
+	if (bSnapshotDirty && ExpectedTileCount <= ArrivedTileCount && ArrivedTileCount == TilePlans.Num())
 	{
-		MapGraph->SetLive();
+		PublishMapSnapshot();
+	}
+
+	if (PendingTiles.IsEmpty() && ActiveStreams.IsEmpty() && RetainedStreams.IsEmpty())
+	{
+		return;
+	}
+
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileSubsystem::TickStreaming [Map=%i, Pending=%i]"), ActiveIndex, PendingTiles.Num());
+
+	bool bBoundsCached = CacheTileBounds();
+	ReleaseWarmSources();
+
+	// Finding the focus tiles tests every tile, so only search again once the map or its bounds
+	// have changed, or a local viewer has moved.
+	TArray<FVector> ViewLocations = FindViewLocations();
+	bool bFocusChanged = bDistancesDirty;
+
+	if (bDistancesDirty || bBoundsCached || HasViewMoved(ViewLocations))
+	{
+		TArray<int32> NewFocusTiles = FindFocusTiles(ViewLocations);
+		bFocusChanged |= NewFocusTiles != FocusTiles;
+		FocusTiles = MoveTemp(NewFocusTiles);
+		FocusViewLocations = MoveTemp(ViewLocations);
+	}
+
+	// Recompute the distances whenever the map grows or a player crosses into another tile.
+	if (bFocusChanged)
+	{
+		UpdateTileDistances();
+
+		// Sort the queue farthest first so that the nearest tile can be popped from the end.
+		PendingTiles.Sort([this](const FPendingTile& A, const FPendingTile& B)
+		{
+			return GetTileDistance(A.PlanIndex) > GetTileDistance(B.PlanIndex);
+		});
+
+		// Loads already in flight should also follow the new order.
+		for (UTilePlanStream* Stream : ActiveStreams)
+		{
+			int32 Distance = GetTileDistance(Stream->PlanIndex);
+			Stream->SetPriority(Distance == MAX_int32 ? MIN_int32 : -Distance);
+		}
+
+		UpdateEviction();
+	}
+
+	// Memory pressure can change without any player moving, so check the budget every tick.
+	else if (IsOverMemoryBudget())
+	{
+		UpdateEviction();
+	}
+
+	// Apply culling every tick, since newly streamed tiles start out visible.
+	UpdatePortalCulling();
+	UpdateTileProxies();
+	UpdateReadiness();
+
+	// Limit the number of loads in flight so that the nearest tiles get the loader to themselves.
+	int32 MaxLoads = CVarTileMaxConcurrentLoads.GetValueOnGameThread();
+	int32 Loads = 0;
+
+	for (UTilePlanStream* Stream : ActiveStreams)
+	{
+		if (Stream->ShouldBeLoaded() && !Stream->IsLevelLoaded() && Stream->GetLevelStreamingState() != ELevelStreamingState::FailedToLoad)
+		{
+			Loads++;
+		}
+	}
+
+	while (!PendingTiles.IsEmpty() && (MaxLoads <= 0 || Loads < MaxLoads))
+	{
+		// Tiles beyond the eviction distance would be unloaded as soon as they arrived, so leave
+		// them queued until a player comes closer.
+		if (!CanStreamTile(PendingTiles.Last().PlanIndex))
+		{
+			break;
+		}
+
+		FPendingTile PendingTile = PendingTiles.Pop(false);
+		StreamTile(PendingTile.Plan, PendingTile.PlanIndex);
+		Loads++;
+	}
+
+	// Once every queued tile has started streaming, no new stream can match a retained stream.
+	if (PendingTiles.IsEmpty())
+	{
+		ReleaseRetainedStreams();
+	}
+
+	// With no loads left in flight and no tiles left queued, the placed levels are held by their
+	// own streams. Tiles held back beyond the eviction distance still need their placed levels.
+	if (Loads == 0 && PendingTiles.IsEmpty() && GeneratorAction.IsValid())
+	{
+		GeneratorAction->ReleasePlacedLevels();
+	}
+}
+
+bool UTileSubsystem::IsPipelining() const
+{
+	return CanGenerate() && GeneratorAction.IsValid() && GeneratorAction->Params.bPipelineStreaming && !PendingSeed.IsSet();
+}
+
+void UTileSubsystem::UpdatePipeline()
+{
+	if (!GeneratorAction.IsValid())
+	{
+		return;
 	}
+
+	FTileGenCommit Commit;
+
+	while (GeneratorAction->DequeueCommit(Commit))
+	{
+		if (!IsPipelining())
+		{
+			continue;
+		}
+
+		TILE_TRACE_SCOPE_TEXT(TEXT("TileSubsystem::PipelineTile [Epoch=%i, Tile=%i]"), Commit.Epoch, Commit.PlanIndex);
+		LLM_SCOPE_BYTAG(IotaTile_Streams);
+
+		// A new epoch means the worker discarded its map, so discard the streams started for it.
+		int32 MapIndex = PipelineBase + Commit.Epoch;
+
+		if (MapIndex != PipelineIndex)
+		{
+			ReleasePipelineStreams();
+			PipelineIndex = MapIndex;
+		}
+
+		// Use the same name the tile would receive once the map goes live, so that the stream can
+		// be adopted as-is. The map index is unique to the epoch, so names never collide with
+		// streams from discarded epochs that are still unloading.
+		FString PlanName = FString::Printf(TEXT("Tile_%i_%i"), MapIndex, Commit.PlanIndex);
+
+		if (UTilePlanStream* NewStream = UTilePlanStream::StreamInstance(GetWorld(), Commit.Plan, PlanName))
+		{
+			// Pipelined tiles load hidden so that attempts which fail never appear in the world.
+			// Earlier plans sit nearer the map root, so they load first.
+			NewStream->PlanIndex = Commit.PlanIndex;
+			NewStream->SetShouldBeVisible(false);
+			NewStream->SetPriority(-Commit.PlanIndex);
+
+			if (PipelineStreams.Num() <= Commit.PlanIndex)
+			{
+				PipelineStreams.SetNum(Commit.PlanIndex + 1);
+			}
+
+			PipelineStreams[Commit.PlanIndex] = NewStream;
+		}
+	}
+}
+
+bool UTileSubsystem::AdoptPipelineStream(int32 PlanIndex)
+{
+	if (PipelineIndex != ActiveIndex || !PipelineStreams.IsValidIndex(PlanIndex) || !PipelineStreams[PlanIndex])
+	{
+		return false;
+	}
+
+	UTilePlanStream* Stream = PipelineStreams[PlanIndex];
+	PipelineStreams[PlanIndex] = nullptr;
+
+	Stream->SetShouldBeVisible(true);
+	ActiveStreams.Emplace(Stream);
+	bBoundsPending = true;
+
+	return true;
+}
+
+void UTileSubsystem::ReleasePipelineStreams()
+{
+	for (UTilePlanStream* Stream : PipelineStreams)
+	{
+		if (Stream)
+		{
+			RetireStream(Stream);
+		}
+	}
+
+	PipelineStreams.Empty();
+	PipelineIndex = INDEX_NONE;
+}
+
+void UTileSubsystem::RetireStream(UTilePlanStream* Stream)
+{
+	// The level stays in the world until its turn comes, just as it would while unloading.
+	RetiringStreams.Emplace(Stream);
+}
+
+void UTileSubsystem::RetirePreviousGraph()
+{
+	if (PreviousGraph.IsValid())
+	{
+		// Release the door indices now, before the new map registers its doors, and leave only
+		// the actors themselves to be destroyed under the retirement budget.
+		PreviousGraph->BeginRetirement();
+		RetiringGraphs.Emplace(PreviousGraph);
+		PreviousGraph.Reset();
+	}
+}
+
+void UTileSubsystem::UpdateRetirement()
+{
+	if (RetiringGraphs.IsEmpty() && RetiringStreams.IsEmpty() && UnloadingStreams.IsEmpty())
+	{
+		return;
+	}
+
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileSubsystem::UpdateRetirement [Graphs=%i, Streams=%i]"), RetiringGraphs.Num(), RetiringStreams.Num());
+
+	// Without a budget, everything retires this frame. Otherwise, work continues until the budget
+	// runs out, but always makes some progress so that retirement cannot stall.
+	float Budget = CVarTileRetireBudget.GetValueOnGameThread();
+	double EndTime = 0 < Budget ? FPlatformTime::Seconds() + Budget / 1000.0 : MAX_dbl;
+
+	while (!RetiringGraphs.IsEmpty())
+	{
+		if (!RetiringGraphs[0]->RetireDoors(EndTime))
+		{
+			return;
+		}
+
+		// With every door gone, releasing the graph itself only frees memory.
+		RetiringGraphs.RemoveAt(0);
+
+		if (EndTime <= FPlatformTime::Seconds())
+		{
+			return;
+		}
+	}
+
+	// Requesting an unload only sets a flag. The cost lands later, when the engine actually
+	// unloads and removes the level, so rate-limit by the number of levels still on their way out
+	// rather than by time.
+	UnloadingStreams.RemoveAll([](const UTilePlanStream* Stream)
+	{
+		return !IsValid(Stream) || !Stream->IsLevelLoaded();
+	});
+
+	int32 MaxUnloads = CVarTileMaxConcurrentUnloads.GetValueOnGameThread();
+	int32 Released = 0;
+
+	for (; Released < RetiringStreams.Num(); Released++)
+	{
+		if (0 < MaxUnloads && MaxUnloads <= UnloadingStreams.Num())
+		{
+			break;
+		}
+
+		if (UTilePlanStream* Stream = RetiringStreams[Released])
+		{
+			Stream->SetIsRequestingUnloadAndRemoval(true);
+
+			// Streams that never loaded have nothing to unload, so they take no slot.
+			if (Stream->IsLevelLoaded())
+			{
+				UnloadingStreams.Emplace(Stream);
+			}
+		}
+	}
+
+	RetiringStreams.RemoveAt(0, Released);
+}
+
+void UTileSubsystem::ReleaseWarmSources()
+{
+	for (UTilePlanStream* Stream : ActiveStreams)
+	{
+		// A stream with no request pending may still be loading, so wait until its level has
+		// actually arrived. Failed loads will never arrive, so there is nothing to keep warm.
+		if (Stream->WarmSource && (Stream->IsLevelLoaded() || Stream->GetLevelStreamingState() == ELevelStreamingState::FailedToLoad))
+		{
+			RetireStream(Stream->WarmSource);
+			Stream->WarmSource = nullptr;
+		}
+	}
+}
+
+void UTileSubsystem::ReleaseRetainedStreams()
+{
+	for (UTilePlanStream* Stream : RetainedStreams)
+	{
+		RetireStream(Stream);
+	}
+
+	RetainedStreams.Empty();
+}
+
+TStatId UTileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTileSubsystem, STATGROUP_Tickables);
+}
+
+TArray<FVector> UTileSubsystem::FindViewLocations() const
+{
+	TArray<FVector> ViewLocations;
+
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		APlayerController* PlayerController = Iterator->Get();
+
+		if (!PlayerController || !PlayerController->IsLocalController())
+		{
+			continue;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		ViewLocations.Add(ViewLocation);
+	}
+
+	return ViewLocations;
+}
+
+bool UTileSubsystem::HasViewMoved(const TArray<FVector>& ViewLocations) const
+{
+	if (ViewLocations.Num() != FocusViewLocations.Num())
+	{
+		return true;
+	}
+
+	for (int32 Index = 0; Index < ViewLocations.Num(); Index++)
+	{
+		if (FocusViewTolerance < FVector::Dist(ViewLocations[Index], FocusViewLocations[Index]))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+TArray<int32> UTileSubsystem::FindFocusTiles(const TArray<FVector>& ViewLocations) const
+{
+	TArray<int32> NewFocusTiles;
+
+	for (const FVector& ViewLocation : ViewLocations)
+	{
+		int32 PlayerTile = FindTileAt(ViewLocation);
+
+		if (PlayerTile != INDEX_NONE)
+		{
+			NewFocusTiles.AddUnique(PlayerTile);
+		}
+	}
+
+	// Without a local player, such as on a dedicated server, stream outward from the map root.
+	if (NewFocusTiles.IsEmpty() && TileParents.IsValidIndex(0))
+	{
+		NewFocusTiles.Add(0);
+	}
+
+	NewFocusTiles.Sort();
+	return NewFocusTiles;
+}
+
+int32 UTileSubsystem::FindTileAt(const FVector& Location) const
+{
+	// Prefer a loaded tile whose level bounds contain the location.
+	for (int32 PlanIndex = 0; PlanIndex < TileBoxes.Num(); PlanIndex++)
+	{
+		if (TileBoxes[PlanIndex].IsSet() && TileBoxes[PlanIndex]->IsInsideOrOn(Location))
+		{
+			return PlanIndex;
+		}
+	}
+
+	// Otherwise, approximate the tile with the nearest tile origin.
+	int32 NearestTile = INDEX_NONE;
+	double NearestDistance = TNumericLimits<double>::Max();
+
+	for (int32 PlanIndex = 0; PlanIndex < TileLocations.Num(); PlanIndex++)
+	{
+		if (!TileLocations[PlanIndex].IsSet())
+		{
+			continue;
+		}
+
+		double Distance = FVector::DistSquared(Location, TileLocations[PlanIndex].GetValue());
+
+		if (Distance < NearestDistance)
+		{
+			NearestTile = PlanIndex;
+			NearestDistance = Distance;
+		}
+	}
+
+	return NearestTile;
+}
+
+bool UTileSubsystem::CacheTileBounds()
+{
+	if (!bBoundsPending)
+	{
+		return false;
+	}
+
+	bool bCached = false;
+	bBoundsPending = false;
+
+	for (UTilePlanStream* Stream : ActiveStreams)
+	{
+		int32 PlanIndex = Stream->PlanIndex;
+
+		if (!TileLocations.IsValidIndex(PlanIndex) || (TileBoxes.IsValidIndex(PlanIndex) && TileBoxes[PlanIndex].IsSet()))
+		{
+			continue;
+		}
+
+		// Level bounds only need to be computed once, since tiles never move after loading.
+		if (!Stream->IsLevelLoaded())
+		{
+			bBoundsPending |= Stream->ShouldBeLoaded();
+			continue;
+		}
+
+		if (TileBoxes.Num() <= PlanIndex)
+		{
+			TileBoxes.SetNum(TileLocations.Num());
+		}
+
+		TILE_TRACE_SCOPE_TEXT(TEXT("TileSubsystem::CacheTileBounds [Map=%i, Tile=%i]"), ActiveIndex, PlanIndex);
+		TileBoxes[PlanIndex] = ALevelBounds::CalculateLevelBounds(Stream->GetLoadedLevel());
+		bCached = true;
+	}
+
+	return bCached;
+}
+
+void UTileSubsystem::UpdateTileDistances()
+{
+	bDistancesDirty = false;
+
+	TileDistances.Init(MAX_int32, TileParents.Num());
+
+	// Tile maps are trees, so children can be rebuilt from the parent links.
+	TArray<TArray<int32>> Children;
+	Children.SetNum(TileParents.Num());
+
+	for (int32 PlanIndex = 0; PlanIndex < TileParents.Num(); PlanIndex++)
+	{
+		if (Children.IsValidIndex(TileParents[PlanIndex]))
+		{
+			Children[TileParents[PlanIndex]].Add(PlanIndex);
+		}
+	}
+
+	// Breadth-first search outward from every focus tile at once through both parents and
+	// children, so that each tile measures its distance to the nearest player.
+	TArray<int32> Queue;
+
+	for (int32 FocusTile : FocusTiles)
+	{
+		if (TileDistances.IsValidIndex(FocusTile))
+		{
+			Queue.Add(FocusTile);
+			TileDistances[FocusTile] = 0;
+		}
+	}
+
+	for (int32 Head = 0; Head < Queue.Num(); Head++)
+	{
+		int32 Current = Queue[Head];
+		int32 NextDistance = TileDistances[Current] + 1;
+
+		auto Visit = [&](int32 Next)
+		{
+			if (TileDistances.IsValidIndex(Next) && TileDistances[Next] == MAX_int32)
+			{
+				TileDistances[Next] = NextDistance;
+				Queue.Add(Next);
+			}
+		};
+
+		Visit(TileParents[Current]);
+
+		for (int32 Child : Children[Current])
+		{
+			Visit(Child);
+		}
+	}
+}
+
+void UTileSubsystem::UpdateEviction()
+{
+	// Servers need every tile loaded for gameplay and collision, so only clients evict.
+	int32 EvictDistance = CVarTileEvictDistance.GetValueOnGameThread();
+
+	if (CanGenerate() || EvictDistance <= 0)
+	{
+		return;
+	}
+
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileSubsystem::UpdateEviction [Map=%i, Streams=%i]"), ActiveIndex, ActiveStreams.Num());
+
+	// Tiles between the reload and eviction distances keep their current state, so that players
+	// moving back and forth across a door do not repeatedly load and unload the same tiles.
+	int32 ReloadDistance = FMath::Clamp(CVarTileReloadDistance.GetValueOnGameThread(), 0, EvictDistance - 1);
+
+	for (UTilePlanStream* Stream : ActiveStreams)
+	{
+		int32 Distance = GetTileDistance(Stream->PlanIndex);
+
+		if (EvictDistance < Distance && Stream->ShouldBeLoaded())
+		{
+			Stream->SetShouldBeVisible(false);
+			Stream->SetShouldBeLoaded(false);
+		}
+		else if (Distance <= ReloadDistance && !Stream->ShouldBeLoaded())
+		{
+			Stream->SetShouldBeLoaded(true);
+			Stream->SetShouldBeVisible(true);
+			bBoundsPending = true;
+		}
+	}
+
+	// Under memory pressure, evict the farthest loaded tile beyond the reload distance. Memory
+	// stats only drop once a level has actually left the world, so no further tile is evicted
+	// for the budget until the last one has unloaded.
+	if (IsValid(BudgetEvictedStream) && BudgetEvictedStream->IsLevelLoaded())
+	{
+		return;
+	}
+
+	BudgetEvictedStream = nullptr;
+
+	if (IsOverMemoryBudget())
+	{
+		UTilePlanStream* Farthest = nullptr;
+
+		for (UTilePlanStream* Stream : ActiveStreams)
+		{
+			int32 Distance = GetTileDistance(Stream->PlanIndex);
+
+			if (ReloadDistance < Distance && Stream->ShouldBeLoaded() && (!Farthest || GetTileDistance(Farthest->PlanIndex) < Distance))
+			{
+				Farthest = Stream;
+			}
+		}
+
+		if (Farthest)
+		{
+			Farthest->SetShouldBeVisible(false);
+			Farthest->SetShouldBeLoaded(false);
+			BudgetEvictedStream = Farthest;
+		}
+	}
+}
+
+void UTileSubsystem::UpdatePortalCulling()
+{
+	int32 CullingMode = CVarTilePortalCulling.GetValueOnGameThread();
+	ENetMode NetMode = GetWorld()->GetNetMode();
+
+	// Dedicated servers render nothing, and hiding levels on the authority removes their collision.
+	bool bCanCull = NetMode != NM_DedicatedServer && (CullingMode == 2 || (CullingMode == 1 && NetMode == NM_Client));
+	bool bHasVisibility = bCanCull && PortalVisibility.IsValid() && !PortalVisibility->IsEmpty() && !FocusTiles.IsEmpty();
+
+	for (UTilePlanStream* Stream : ActiveStreams)
+	{
+		// Evicted tiles are hidden by the eviction pass, so leave them alone.
+		if (!Stream->ShouldBeLoaded())
+		{
+			continue;
+		}
+
+		bool bVisible = !bHasVisibility;
+
+		for (int32 Index = 0; Index < FocusTiles.Num() && !bVisible; Index++)
+		{
+			bVisible = PortalVisibility->IsVisible(FocusTiles[Index], Stream->PlanIndex);
+		}
+
+		if (Stream->GetShouldBeVisibleFlag() != bVisible)
+		{
+			Stream->SetShouldBeVisible(bVisible);
+		}
+	}
+}
+
+void UTileSubsystem::UpdateTileProxies()
+{
+	TArray<int32> NewProxyTiles;
+
+	if (CVarTileProxies.GetValueOnGameThread() && GetWorld()->GetNetMode() != NM_DedicatedServer && !TileBounds.IsEmpty())
+	{
+		// Tiles with a visible level need no proxy.
+		TBitArray<> VisibleTiles(false, TileBounds.Num());
+
+		for (UTilePlanStream* Stream : ActiveStreams)
+		{
+			if (VisibleTiles.IsValidIndex(Stream->PlanIndex) && Stream->IsLevelVisible())
+			{
+				VisibleTiles[Stream->PlanIndex] = true;
+			}
+		}
+
+		bool bHasVisibility = PortalVisibility.IsValid() && !PortalVisibility->IsEmpty() && !FocusTiles.IsEmpty();
+
+		for (int32 PlanIndex = 0; PlanIndex < TileBounds.Num(); PlanIndex++)
+		{
+			if (VisibleTiles[PlanIndex])
+			{
+				continue;
+			}
+
+			// Tiles culled by the portal visibility would not be seen in full detail either.
+			bool bInView = !bHasVisibility;
+
+			for (int32 Index = 0; Index < FocusTiles.Num() && !bInView; Index++)
+			{
+				bInView = PortalVisibility->IsVisible(FocusTiles[Index], PlanIndex);
+			}
+
+			if (bInView)
+			{
+				NewProxyTiles.Add(PlanIndex);
+			}
+		}
+	}
+
+	// Rebuilding the instances is cheap but not free, so only do it when the proxied set changes.
+	if (NewProxyTiles == ProxyTiles)
+	{
+		return;
+	}
+
+	ProxyTiles = MoveTemp(NewProxyTiles);
+
+	if (!ProxyActor && !ProxyTiles.IsEmpty())
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		ProxyActor = GetWorld()->SpawnActor<ATileProxyActor>(SpawnParams);
+	}
+
+	if (ProxyActor)
+	{
+		TArray<const FTileBound*> Bounds;
+
+		for (int32 PlanIndex : ProxyTiles)
+		{
+			for (const FTileBound& Bound : TileBounds[PlanIndex])
+			{
+				Bounds.Add(&Bound);
+			}
+		}
+
+		ProxyActor->SetBounds(Bounds);
+	}
+}
+
+/** Records a tile load latency in the CSV profiler, both as a raw value and as a histogram bucket. */
+static void RecordLoadLatency(double Seconds)
+{
+	float Milliseconds = static_cast<float>(Seconds * 1000.0);
+
+	CSV_CUSTOM_STAT(IotaTile, TileLoadMs, Milliseconds, ECsvCustomStatOp::Max);
+	CSV_CUSTOM_STAT(IotaTile, TilesLoaded, 1, ECsvCustomStatOp::Accumulate);
+
+	if (Milliseconds < 100)
+	{
+		CSV_CUSTOM_STAT(IotaTile, TileLoadUnder100ms, 1, ECsvCustomStatOp::Accumulate);
+	}
+	else if (Milliseconds < 250)
+	{
+		CSV_CUSTOM_STAT(IotaTile, TileLoadUnder250ms, 1, ECsvCustomStatOp::Accumulate);
+	}
+	else if (Milliseconds < 500)
+	{
+		CSV_CUSTOM_STAT(IotaTile, TileLoadUnder500ms, 1, ECsvCustomStatOp::Accumulate);
+	}
+	else if (Milliseconds < 1000)
+	{
+		CSV_CUSTOM_STAT(IotaTile, TileLoadUnder1s, 1, ECsvCustomStatOp::Accumulate);
+	}
+	else if (Milliseconds < 2000)
+	{
+		CSV_CUSTOM_STAT(IotaTile, TileLoadUnder2s, 1, ECsvCustomStatOp::Accumulate);
+	}
+	else
+	{
+		CSV_CUSTOM_STAT(IotaTile, TileLoadOver2s, 1, ECsvCustomStatOp::Accumulate);
+	}
+}
+
+void UTileSubsystem::UpdateReadiness()
+{
+	double Now = FPlatformTime::Seconds();
+
+	TArray<UTilePlanStream*> StreamsByPlan;
+	StreamsByPlan.SetNumZeroed(TileTimings.Num());
+
+	for (UTilePlanStream* Stream : ActiveStreams)
+	{
+		if (!TileTimings.IsValidIndex(Stream->PlanIndex))
+		{
+			continue;
+		}
+
+		StreamsByPlan[Stream->PlanIndex] = Stream;
+		FTileTiming& Timing = TileTimings[Stream->PlanIndex];
+
+		if (Timing.RequestTime == 0)
+		{
+			Timing.RequestTime = Stream->RequestTime;
+		}
+
+		if (Timing.LoadedTime == 0 && Stream->IsLevelLoaded())
+		{
+			Timing.LoadedTime = Now;
+			RecordLoadLatency(Timing.LoadedTime - Timing.RequestTime);
+
+			UE_LOG(LogIotaTile, Verbose, TEXT("Tile %i (%s) loaded in %.1f ms after %.1f ms queued."), Stream->PlanIndex, *Stream->SourcePackage.ToString(), (Timing.LoadedTime - Timing.RequestTime) * 1000.0, (Timing.RequestTime - Timing.QueueTime) * 1000.0);
+		}
+
+		if (Timing.VisibleTime == 0 && Stream->IsLevelVisible())
+		{
+			Timing.VisibleTime = Now;
+			CSV_CUSTOM_STAT(IotaTile, TileVisibleMs, static_cast<float>((Timing.VisibleTime - Timing.RequestTime) * 1000.0), ECsvCustomStatOp::Max);
+		}
+	}
+
+	if (bMapReady || TileTimings.Num() < ExpectedTileCount)
+	{
+		return;
+	}
+
+	// Without a focus tile every tile is infinitely far away, so a distance limit would pass the
+	// map before anything had loaded. Require every tile instead.
+	int32 ReadyDistance = FocusTiles.IsEmpty() ? INDEX_NONE : CVarTileReadyDistance.GetValueOnGameThread();
+
+	for (int32 PlanIndex = 0; PlanIndex < TileTimings.Num(); PlanIndex++)
+	{
+		if (0 <= ReadyDistance && ReadyDistance < GetTileDistance(PlanIndex))
+		{
+			continue;
+		}
+
+		// Tiles that never arrived, or have not started streaming, are not ready. Tiles that are
+		// deliberately unloaded or hidden are ready once their level is in the wanted state.
+		UTilePlanStream* Stream = StreamsByPlan[PlanIndex];
+
+		if (!Stream)
+		{
+			return;
+		}
+
+		bool bReady = !Stream->ShouldBeLoaded() || (Stream->IsLevelLoaded() && (Stream->IsLevelVisible() || !Stream->GetShouldBeVisibleFlag()));
+
+		if (!bReady)
+		{
+			return;
+		}
+	}
+
+	bMapReady = true;
+
+	// Find the slowest tile so that problem levels show up in the logs.
+	int32 SlowestTile = INDEX_NONE;
+	double SlowestTime = 0;
+
+	for (int32 PlanIndex = 0; PlanIndex < TileTimings.Num(); PlanIndex++)
+	{
+		const FTileTiming& Timing = TileTimings[PlanIndex];
+
+		if (Timing.LoadedTime != 0 && SlowestTime < Timing.LoadedTime - Timing.RequestTime)
+		{
+			SlowestTile = PlanIndex;
+			SlowestTime = Timing.LoadedTime - Timing.RequestTime;
+		}
+	}
+
+	UE_LOG(LogIotaTile, Log, TEXT("Map %i ready after %.1f ms. Slowest tile: %i (%s, %.1f ms)."),
+		ActiveIndex,
+		(Now - MapStartTime) * 1000.0,
+		SlowestTile,
+		StreamsByPlan.IsValidIndex(SlowestTile) && StreamsByPlan[SlowestTile] ? *StreamsByPlan[SlowestTile]->SourcePackage.ToString() : TEXT("None"),
+		SlowestTime * 1000.0);
+
+	CSV_CUSTOM_STAT(IotaTile, MapReadyMs, static_cast<float>((Now - MapStartTime) * 1000.0), ECsvCustomStatOp::Set);
+	CSV_EVENT(IotaTile, TEXT("TileMapReady %i"), ActiveIndex);
+
+	OnTileMapReady.Broadcast(ActiveIndex);
+}
+
+void UTileSubsystem::PublishMapSnapshot()
+{
+	TILE_TRACE_SCOPE_TEXT(TEXT("TileSubsystem::PublishMapSnapshot [Map=%i, Tiles=%i]"), ActiveIndex, TilePlans.Num());
+
+	TSharedRef<FTileMapSnapshot> Snapshot = MakeShared<FTileMapSnapshot>(ActiveIndex);
+	int32 GraphTiles = 0;
+
+	// Only the server map graph knows the doors. Tiles appended after it went live follow it.
+	if (CanGenerate() && MapGraph.IsValid() && MapGraph->IsLive() && MapGraph->GetSize() <= TilePlans.Num())
+	{
+		Snapshot->AddMapGraph(*MapGraph);
+		GraphTiles = MapGraph->GetSize();
+	}
+
+	for (int32 PlanIndex = GraphTiles; PlanIndex < TilePlans.Num(); PlanIndex++)
+	{
+		Snapshot->AddTile(TilePlans[PlanIndex], TileBounds.IsValidIndex(PlanIndex) ? TileBounds[PlanIndex] : TArray<FTileBound>());
+	}
+
+	for (int32 PlanIndex = GraphTiles; PlanIndex < TilePlans.Num(); PlanIndex++)
+	{
+		int32 Parent = TilePlans[PlanIndex].Parent;
+
+		if (TilePlans.IsValidIndex(Parent) && Parent != PlanIndex)
+		{
+			Snapshot->AddDoor(PlanIndex, Parent, TileDoors.IsValidIndex(PlanIndex) ? TileDoors[PlanIndex] : FTileSnapshotDoor());
+		}
+	}
+
+	Snapshot->Finish();
+	GetSnapshotPublisher()->Publish(Snapshot);
+	bSnapshotDirty = false;
+}
+
+bool UTileSubsystem::IsTileMapReady() const
+{
+	return bMapReady;
+}
+
+bool UTileSubsystem::GetTileLatency(int32 PlanIndex, float& OutLoadSeconds, float& OutVisibleSeconds) const
+{
+	OutLoadSeconds = -1;
+	OutVisibleSeconds = -1;
+
+	if (!TileTimings.IsValidIndex(PlanIndex) || TileTimings[PlanIndex].RequestTime == 0)
+	{
+		return false;
+	}
+
+	const FTileTiming& Timing = TileTimings[PlanIndex];
+
+	if (Timing.LoadedTime != 0)
+	{
+		OutLoadSeconds = static_cast<float>(Timing.LoadedTime - Timing.RequestTime);
+	}
+
+	if (Timing.VisibleTime != 0)
+	{
+		OutVisibleSeconds = static_cast<float>(Timing.VisibleTime - Timing.RequestTime);
+	}
+
+	return true;
+}
+
+bool UTileSubsystem::CanStreamTile(int32 PlanIndex) const
+{
+	int32 EvictDistance = CVarTileEvictDistance.GetValueOnGameThread();
+
+	if (CanGenerate() || EvictDistance <= 0)
+	{
+		return true;
+	}
+
+	// Under memory pressure, only new tiles within the reload distance may stream.
+	int32 Limit = IsOverMemoryBudget() ? FMath::Clamp(CVarTileReloadDistance.GetValueOnGameThread(), 0, EvictDistance - 1) : EvictDistance;
+	return GetTileDistance(PlanIndex) <= Limit;
+}
+
+bool UTileSubsystem::IsOverMemoryBudget() const
+{
+	int32 BudgetMB = CVarTileMemoryBudget.GetValueOnGameThread();
+	return 0 < BudgetMB && static_cast<uint64>(BudgetMB) * 1024 * 1024 < FPlatformMemory::GetStats().UsedPhysical;
+}
+
+int32 UTileSubsystem::GetTileDistance(int32 PlanIndex) const
+{
+	return TileDistances.IsValidIndex(PlanIndex) ? TileDistances[PlanIndex] : MAX_int32;
+}
+
+int32 UTileSubsystem::GetActiveIndex() const
+{
+	return ActiveIndex;
+}
+
+TSharedPtr<const FTileMapGraph> UTileSubsystem::GetMapGraph() const
+{
+	return MapGraph;
+}
+
+TSharedPtr<const FTileMapSnapshot> UTileSubsystem::GetMapSnapshot() const
+{
+	return SnapshotPublisher.IsValid() ? SnapshotPublisher->Acquire() : nullptr;
+}
+
+TSharedRef<FTileMapSnapshotPublisher> UTileSubsystem::GetSnapshotPublisher()
+{
+	if (!SnapshotPublisher.IsValid())
+	{
+		SnapshotPublisher = MakeShared<FTileMapSnapshotPublisher>();
+	}
+
+	return SnapshotPublisher.ToSharedRef();
+}
+
+bool UTileSubsystem::FindTileRoute(const FVector& Start, const FVector& Goal, TArray<FVector>& OutWaypoints, bool bRefine)
+{
+	OutWaypoints.Reset();
+
+	// The planner is built when the map graph goes live, so a graph still being generated may not
+	// match the planner.
+	if (!MapGraph.IsValid() || !MapGraph->IsLive() || !PathPlanner.IsValid() || PathPlanner->IsEmpty())
+	{
+		return false;
+	}
+
+	const TArray<int32>* Route = PathPlanner->FindRoute(MapGraph->FindTile(Start), MapGraph->FindTile(Goal));
+
+	if (!Route)
+	{
+		return false;
+	}
+
+	for (int32 Door : *Route)
+	{
+		OutWaypoints.Add(PathPlanner->GetDoorLocation(Door));
+	}
+
+	OutWaypoints.Add(Goal);
+
+	if (bRefine)
+	{
+		TILE_TRACE_SCOPE_TEXT(TEXT("TileSubsystem::RefineTileRoute [Doors=%i]"), Route->Num());
+
+		// Only the first two legs are refined: the one through the start tile, which ends at its
+		// exit door, and the one through the next tile. Legs without a complete navigation path
+		// keep their straight segment.
+		int32 NumRefined = FMath::Min(2, OutWaypoints.Num());
+
+		TArray<FVector> Refined;
+		FVector LegStart = Start;
+
+		for (int32 Index = 0; Index < NumRefined; Index++)
+		{
+			UNavigationPath* Path = UNavigationSystemV1::FindPathToLocationSynchronously(GetWorld(), LegStart, OutWaypoints[Index]);
+
+			if (Path && Path->IsValid() && !Path->IsPartial() && 1 < Path->PathPoints.Num())
+			{
+				// Every navigation path begins at the leg start, which is already on the route.
+				Refined.Append(Path->PathPoints.GetData() + 1, Path->PathPoints.Num() - 1);
+			}
+			else
+			{
+				Refined.Add(OutWaypoints[Index]);
+			}
+
+			LegStart = OutWaypoints[Index];
+		}
+
+		Refined.Append(OutWaypoints.GetData() + NumRefined, OutWaypoints.Num() - NumRefined);
+		OutWaypoints = MoveTemp(Refined);
+	}
+
+	return true;
+}
+
+void UTileSubsystem::RegisterMapComponent(UTileMapComponent* NewMapComponent)
+{
+	MapComponent = NewMapComponent;
+}
+
+UTileMapComponent* UTileSubsystem::GetMapComponent() const
+{
+	return MapComponent.Get();
+}
+
+void UTileSubsystem::RegisterDoor(ATileDoorBase* Door)
+{
+	if (IsValid(Door) && Door->DoorIndex != INDEX_NONE)
+	{
+		Doors.Add(Door->DoorIndex, Door);
+	}
+}
+
+void UTileSubsystem::UnregisterDoor(ATileDoorBase* Door)
+{
+	// Doors from an old map can end play after a new door has claimed their index.
+	if (Door && Doors.FindRef(Door->DoorIndex) == Door)
+	{
+		Doors.Remove(Door->DoorIndex);
+	}
+}
+
+ATileDoorBase* UTileSubsystem::FindDoor(int32 DoorIndex) const
+{
+	return Doors.FindRef(DoorIndex).Get();
 }
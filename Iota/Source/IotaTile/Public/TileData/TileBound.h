@@ -69,6 +69,14 @@ public:
 		return CheckCollision(*this, Other);
 	}
 
+	/**
+	 * Determines if the given point lies within the tile bound.
+	 *
+	 * @param Point Point to test, in the same space as the tile bound.
+	 * @return True if the point is inside the oriented box.
+	 */
+	bool Contains(const FVector& Point) const;
+
 	/** Determines if the given tile bounds are intersecting each other. */
 	static bool CheckCollision(const FTileBound& A, const FTileBound& B);
 
@@ -27,6 +27,13 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	TArray<FTileBound> Bounds;
 
+	/**
+	 * Walking distance between each pair of portals, stored as a square matrix in row order with
+	 * one row per portal. Empty if the distances have not been exported.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TArray<float> PortalDistances;
+
 	/** Defines an empty tile data structure. */
 	FTileData();
 
@@ -36,8 +43,9 @@ public:
 	 * @param InLevel Pointer to the tile level asset.
 	 * @param InPortals A list of the tile's exit portals.
 	 * @param InBounds A list of the tile's collision bounds.
+	 * @param InPortalDistances Walking distance between each pair of portals.
 	 */
-	FTileData(const TSoftObjectPtr<UWorld>& InLevel, const TArray<FTilePortal>& InPortals, const TArray<FTileBound>& InBounds);
+	FTileData(const TSoftObjectPtr<UWorld>& InLevel, const TArray<FTilePortal>& InPortals, const TArray<FTileBound>& InBounds, const TArray<float>& InPortalDistances = TArray<float>());
 
 	/**
 	 * Duplicates the given tile data and optionally transforms its components.
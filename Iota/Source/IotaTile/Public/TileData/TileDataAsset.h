@@ -43,6 +43,13 @@ public:
 	UPROPERTY(Category = "Attributes", EditAnywhere)
 	TArray<FTileBound> Bounds;
 
+	/**
+	 * Walking distance in world units between each pair of exit portals, stored as a square matrix
+	 * in row order with one row per portal. Exported alongside the portals.
+	 */
+	UPROPERTY(Category = "Attributes", VisibleAnywhere)
+	TArray<float> PortalDistances;
+
 	/**
 	 * Converts the tile data asset into generation data.
 	 *
@@ -50,4 +57,7 @@ public:
 	 */
 	UFUNCTION(BlueprintPure, Category = "Tile|TileData")
 	FTileData GetTileData() const;
+
+	/** Serializes the tile data asset under the tile asset memory tag. */
+	virtual void Serialize(FArchive& Archive) override;
 };
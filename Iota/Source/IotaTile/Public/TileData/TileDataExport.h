@@ -49,6 +49,15 @@ public:
 	UPROPERTY(Category = "ExportLevel", EditAnywhere)
 	bool bAutoCreateAsset = true;
 
+	/**
+	 * True if purely cosmetic primitives in the level should be excluded from dedicated server
+	 * loads. A primitive is cosmetic if it is static, has no collision, cannot affect navigation,
+	 * and belongs to an actor that does not replicate. The export manages the load-on-server flag
+	 * of every primitive in the level, so clearing this option restores it on all of them.
+	 */
+	UPROPERTY(Category = "ExportLevel", EditAnywhere)
+	bool bStripCosmeticsOnServer = true;
+
 	ATileDataExport();
 
 private:
@@ -85,6 +94,21 @@ public:
 
 protected:
 
+	/**
+	 * Marks the cosmetic primitives in the level so that cooked dedicated servers skip loading
+	 * them, and unmarks every other primitive.
+	 */
+	void MarkCosmeticPrimitives();
+
+	/**
+	 * Measures the walking distance between each pair of exported portals and stores the results
+	 * in the data asset. Distances follow the level navigation mesh where a complete path exists,
+	 * and fall back on the straight-line distance otherwise.
+	 *
+	 * @param DataAssetObject Data asset whose portals have already been exported.
+	 */
+	void ExportPortalDistances(UTileDataAsset* DataAssetObject) const;
+
 	/** Actually exports the actor into the linked data asset. */
 	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
 };
@@ -0,0 +1,87 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TileData/TilePlan.h"
+#include "TileMapPack.generated.h"
+
+class UPackageMap;
+
+/**
+ * Tile map container that serializes compactly over the network. Level paths are sent once in a
+ * string table and referenced by index, and plans sitting on the tileset grid relative to the map
+ * origin are sent as grid coordinates with a quarter-turn yaw. Plans that are off the grid fall
+ * back to the full-precision tile plan format.
+ */
+USTRUCT(BlueprintType)
+struct IOTATILE_API FTileMapPack
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Tile plans in the tile map. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TArray<FTilePlan> Plans;
+
+	/** World origin of the tile map. Plans are quantized relative to this point. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FVector Origin;
+
+	/** World yaw of the tile map. Plans are quantized relative to this angle. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	float OriginYaw = 0;
+
+	/** Grid spacing used to quantize plan locations. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = 1))
+	float GridSize = 100;
+
+	/** Server map index used to ensure safe replication. Zero if the pack is empty. */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	int32 MapIndex = 0;
+
+	/** Defines an empty tile map pack. */
+	FTileMapPack();
+
+	/**
+	 * Compresses the tile map to minimize its network size. Corrupt or out-of-range data fails the
+	 * read rather than producing a partial map.
+	 *
+	 * @param Archive Archive object from which to read and write.
+	 * @param PackageMap Package map for resolving UObject pointers.
+	 * @param bOutSuccess True if no errors were encountered.
+	 * @return True if the tile map was fully serialized.
+	 */
+	bool NetSerialize(FArchive& Archive, UPackageMap* PackageMap, bool& bOutSuccess);
+
+private:
+
+	/**
+	 * Attempts to quantize a tile plan onto the grid relative to the map origin.
+	 *
+	 * @param TilePlan Tile plan to quantize.
+	 * @param OutCell Grid cell containing the plan location.
+	 * @param OutQuarter Number of quarter turns in the plan yaw.
+	 * @return True if the plan sits on the grid with a quarter-turn yaw.
+	 */
+	bool Quantize(const FTilePlan& TilePlan, FIntVector& OutCell, uint8& OutQuarter) const;
+
+	/**
+	 * Restores a tile plan transform from its grid cell and quarter turns.
+	 *
+	 * @param TilePlan Tile plan to write the transform to.
+	 * @param Cell Grid cell containing the plan location.
+	 * @param Quarter Number of quarter turns in the plan yaw.
+	 */
+	void Dequantize(FTilePlan& TilePlan, const FIntVector& Cell, uint8 Quarter) const;
+};
+
+template<>
+struct TStructOpsTypeTraits<FTileMapPack> : public TStructOpsTypeTraitsBase2<FTileMapPack>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
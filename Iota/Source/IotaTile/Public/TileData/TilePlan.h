@@ -27,6 +27,13 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	FRotator Rotation;
 
+	/**
+	 * Index of the plan through which this plan connects to the map root. Negative for the root
+	 * and for plans created outside the generator.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	int32 Parent = INDEX_NONE;
+
 	/** Defines a default tile plan. */
 	FTilePlan();
 
@@ -57,6 +64,15 @@ public:
 	bool NetSerialize(FArchive& Archive, UPackageMap* PackageMap, bool& bOutSuccess);
 };
 
+/**
+ * Hashes a tile plan by its level path and its transform rounded to a tenth of a unit, so that
+ * plans generated independently on different machines hash equally.
+ *
+ * @param TilePlan Tile plan to hash.
+ * @return Hash value for the tile plan.
+ */
+IOTATILE_API uint32 GetTypeHash(const FTilePlan& TilePlan);
+
 template<>
 struct TStructOpsTypeTraits<FTilePlan> : public TStructOpsTypeTraitsBase2<FTilePlan>
 {
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "TileGen/TileGenParams.h"
+#include "TileGen/TileGenReport.h"
+#include "TileData/TilePlan.h"
 
 class FTileGenWorker;
 
@@ -11,6 +13,22 @@ struct FTileGraphPlan;
 struct FPrimaryAssetId;
 struct FStreamableHandle;
 
+/** Tile plan accepted by the generation worker, published while the worker is still running. */
+struct IOTATILE_API FTileGenCommit
+{
+	/** Accepted tile plan. */
+	FTilePlan Plan;
+
+	/** Index of the plan within the tile map. */
+	int32 PlanIndex = INDEX_NONE;
+
+	/**
+	 * Map epoch to which the plan belongs. The epoch changes whenever the worker discards its
+	 * tile map, which invalidates every plan committed under the previous epoch.
+	 */
+	int32 Epoch = 0;
+};
+
 /** Asynchronous generation action. */
 class IOTATILE_API FTileGenAction
 {
@@ -21,10 +39,14 @@ public:
 	 * Asynchronously generates a new tile map from the provided parameters, invoking the given
 	 * delegate once generation is complete.
 	 *
+	 * When replaying a tile map generated elsewhere, pass in the budget cutoff recorded with that
+	 * map so that the generator exhausts its budget at the same point regardless of local timing.
+	 *
 	 * @param InParams Tile map generation parameters.
 	 * @param InDelegate Delegate invoked when the action generates a map.
+	 * @param InBudgetCutoff Recorded budget cutoff to replay, or INDEX_NONE for a new tile map.
 	 */
-	FTileGenAction(const FTileGenParams& InParams, const FSimpleDelegate& InDelegate);
+	FTileGenAction(const FTileGenParams& InParams, const FSimpleDelegate& InDelegate, int32 InBudgetCutoff = INDEX_NONE);
 
 	/** Ensures that the Asset Manager releases requested assets. */
 	~FTileGenAction();
@@ -48,14 +70,31 @@ public:
 	bool CanAccess() const;
 
 	/**
-	 * Checks to see if the tile map generated by the asynchronous worker is complete - that is,
-	 * the map contains the complete tile sequence specified by the parameters. If the worker is
-	 * still inaccessible, this method will return false.
+	 * Checks to see if the tile map generated by the asynchronous worker is usable - that is, the
+	 * map contains the complete tile sequence specified by the parameters, or a best-effort map
+	 * ending in an exit if the generation budget ran out. If the worker is still inaccessible,
+	 * this method will return false.
 	 *
-	 * @return True if the map contains a complete core tile sequence.
+	 * @return True if the map contains a usable core tile sequence.
 	 */
 	bool IsMapValid() const;
 
+	/**
+	 * Returns the quality of the tile map generated by the asynchronous worker. If the worker is
+	 * still inaccessible, this method will return ETileGenQuality::None.
+	 *
+	 * @return Quality of the generated tile map.
+	 */
+	ETileGenQuality GetQuality() const;
+
+	/**
+	 * Returns the number of core (non-terminal) tiles at the front of the generated tile map. This
+	 * equals the parameter length for complete maps, but may be shorter for best-effort maps.
+	 *
+	 * @return Number of core tiles in the generated tile map.
+	 */
+	int32 GetCoreLength() const;
+
 	/**
 	 * Provides a pointer to the array of tile plans produced by the asynchronous worker. If the
 	 * worker has not finished generating a tile map, a null pointer will be returned instead.
@@ -64,6 +103,81 @@ public:
 	 */
 	const TArray<FTileGraphPlan>* GetTileMap() const;
 
+	/**
+	 * Returns the report describing the most recent generation attempt, including why it failed
+	 * if the map is not valid. If the worker is still inaccessible, an empty report is returned.
+	 *
+	 * @return Report for the most recent generation attempt.
+	 */
+	FTileGenReport GetReport() const;
+
+	/**
+	 * Returns a hash of the tile data loaded by the action. Two actions with equal parameters and
+	 * equal tileset hashes generate equal tile maps. If the worker has not been created yet, this
+	 * method will return zero.
+	 *
+	 * @return Hash of the loaded tile data.
+	 */
+	uint32 GetTilesetHash() const;
+
+	/**
+	 * Returns a hash of the tile plans in the generated tile map, which can be used to verify that
+	 * a tile map generated elsewhere from the same seed matches. If the worker is still
+	 * inaccessible, this method will return zero.
+	 *
+	 * @return Hash of the generated tile map.
+	 */
+	uint32 GetMapHash() const;
+
+	/**
+	 * Returns the budget check at which the generation budget was exhausted, which must be passed
+	 * to actions replaying the tile map. If the budget was never exhausted, or the worker is still
+	 * inaccessible, this method will return zero.
+	 *
+	 * @return Budget cutoff for the generated tile map.
+	 */
+	int32 GetBudgetCutoff() const;
+
+	/**
+	 * Raises the load priority of the tile levels placed in the generated tile map above the rest
+	 * of the prefetched tileset, and drops the raised priority of levels only placed by discarded
+	 * attempts. Does nothing unless the parameters prefetch levels and the worker is accessible.
+	 */
+	void PrioritizeLevels();
+
+	/**
+	 * Releases the prefetched tileset once the generated map has gone live, so that levels the map
+	 * never placed can be garbage collected. Placed levels stay requested until released with
+	 * ReleasePlacedLevels.
+	 */
+	void ReleasePrefetch();
+
+	/**
+	 * Releases the placed levels raised in priority, once their streams have loaded and keep them
+	 * resident on their own. Does nothing until the prefetch has been released, since levels are
+	 * still being placed until then.
+	 */
+	void ReleasePlacedLevels();
+
+	/**
+	 * Pops the oldest tile plan committed by the worker, if the parameters pipeline streaming or
+	 * prefetch levels, and raises the load priority of its level. Must only be called from the
+	 * game thread.
+	 *
+	 * @param OutCommit Oldest committed tile plan, if one exists.
+	 * @return True if a committed plan was popped.
+	 */
+	bool DequeueCommit(FTileGenCommit& OutCommit);
+
+	/**
+	 * Returns the epoch of the tile map generated by the asynchronous worker, which matches the
+	 * epoch of every plan committed for that map. If the worker is still inaccessible, this
+	 * method will return zero.
+	 *
+	 * @return Epoch of the generated tile map.
+	 */
+	int32 GetEpoch() const;
+
 public:
 
 	/** Action generation parameters. */
@@ -74,17 +188,33 @@ private:
 	/** Invoked by the engine when it has loaded the assets the action requested. */
 	void NotifyAssetsLoaded();
 
+	/**
+	 * Requests a prefetched tile level at high priority, if it has not been requested already.
+	 *
+	 * @param Level Tile level placed by the worker.
+	 */
+	void PrioritizeLevel(const TSoftObjectPtr<UWorld>& Level);
+
 private:
 
 	/** Delegate invoked when the generation action completes. */
 	FSimpleDelegate OnComplete;
 
+	/** Budget cutoff passed to the worker when replaying a tile map. */
+	int32 BudgetCutoff = INDEX_NONE;
+
 	/** Assets requested by the action. */
 	TArray<FPrimaryAssetId> ActionAssetList;
 
 	/** Handle used to track asset loading. */
 	TSharedPtr<FStreamableHandle> ActionAssetHandle;
 
+	/** Handle keeping every tile level in the tileset loaded, if prefetching levels. */
+	TSharedPtr<FStreamableHandle> LevelPrefetchHandle;
+
+	/** Handles requesting each tile level placed by the worker at high priority, keyed by level path. */
+	TMap<FSoftObjectPath, TSharedPtr<FStreamableHandle>> LevelPriorityHandles;
+
 	/** Asynchronous worker dispatched by the action. */
 	TSharedPtr<FTileGenWorker> AsyncWorker;
 };
@@ -54,6 +54,54 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = 0))
 	int32 Branch = 1;
 
+	/**
+	 * If true, the generator will adapt its search across regeneration attempts using the steps
+	 * that failed previously. Failing steps widen their branch search, and the steps leading into
+	 * them prefer tiles with more portals.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bAdaptive = false;
+
+	/**
+	 * Wall-clock budget for the whole generation process in seconds, including regeneration
+	 * attempts. Once exceeded, the generator returns a best-effort map instead of retrying.
+	 * Zero or less disables the budget. Time budgets depend on machine speed, so seeded tile maps
+	 * record the point at which the budget ran out for replays to reproduce.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = 0, Units = "Seconds"))
+	float TimeBudget = 0;
+
+	/**
+	 * Maximum number of tile placement checks across all generation attempts. Once exceeded, the
+	 * generator returns a best-effort map instead of retrying. Zero or less disables the budget.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = 0))
+	int32 PlacementBudget = 0;
+
+	/**
+	 * Grid spacing to which the tileset is authored, in world units. Tile plans that sit on this
+	 * grid relative to the map origin replicate in a quantized form when packed.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = 1, Units = "Centimeters"))
+	float GridSize = 100;
+
+	/**
+	 * If true, the tile levels in the tileset begin loading in the background as soon as the
+	 * tileset is loaded, and levels are raised in priority as the generator places them. Streaming
+	 * the map then mostly loads from memory rather than disk, at the cost of briefly loading
+	 * levels that end up unused, which are released once the map goes live.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bPrefetchLevels = false;
+
+	/**
+	 * If true, tiles start streaming in hidden as soon as the generator places them rather than
+	 * once the whole map is complete, so that generation and loading overlap. Tiles placed by
+	 * attempts that fail are unloaded again. Only applies to maps generated on the server.
+	 */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	bool bPipelineStreaming = false;
+
 	/** Random seed value with which to generate the tile map. */
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	int32 Seed = 0;
@@ -0,0 +1,93 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TileData/TileScheme.h"
+
+/** Describes why the generator was unable to place a tile. */
+enum class ETileGenFailure : uint8
+{
+	/** The generator has not failed. */
+	None,
+
+	/** The palette for the failing scheme contained no tiles. */
+	EmptyPalette,
+
+	/** The tile map had no vacant portals within the branch search depth. */
+	NoOpenPortals,
+
+	/** No vacant portal shared a plane size with any portal on the candidate tiles. */
+	NoMatchingPortals,
+
+	/** Every size-compatible connection collided with the existing tile map. */
+	Collisions,
+
+	/** The tileset cannot produce a valid map with the given parameters, so no attempt was made. */
+	Infeasible,
+
+	/** The generation time or placement budget ran out before the step could finish. */
+	OverBudget,
+};
+
+/** Describes the quality of the tile map produced by the generator. */
+enum class ETileGenQuality : uint8
+{
+	/** The generator has not produced a usable tile map. */
+	None,
+
+	/** The tile map contains the complete tile sequence specified by the parameters. */
+	Complete,
+
+	/**
+	 * The generation budget ran out, so the tile map is the longest partial sequence found across
+	 * all attempts, trimmed back until an exit tile could be attached to its end.
+	 */
+	BestEffort,
+};
+
+/** Records the outcome of a single generation attempt. */
+struct IOTATILE_API FTileGenReport
+{
+	/** Reason the attempt failed, if it failed. */
+	ETileGenFailure Failure = ETileGenFailure::None;
+
+	/** Scheme the generator was attempting to place when it failed. */
+	ETileScheme Scheme = ETileScheme::Start;
+
+	/** Scheme sequence index at which the generator failed. Negative if the attempt succeeded. */
+	int32 SequenceIndex = -1;
+
+	/** Number of generation attempts made by the worker, including this one. */
+	int32 Attempt = 0;
+
+	/** Number of candidate tiles tried at the failing step. */
+	int32 Candidates = 0;
+
+	/** Number of vacant tile map portals found at the failing step. */
+	int32 OpenPortals = 0;
+
+	/** Number of size-compatible portal connections tried at the failing step. */
+	int32 Connections = 0;
+
+	/** Number of size-compatible connections rejected due to collisions at the failing step. */
+	int32 Collisions = 0;
+
+	/** Explanation produced by the tileset feasibility check when the tileset is infeasible. */
+	FString Diagnostic;
+
+	/** @return True if the report describes a failed attempt. */
+	bool IsFailure() const
+	{
+		return Failure != ETileGenFailure::None;
+	}
+
+	/** @return True if the report shows that no attempt can ever succeed. */
+	bool IsInfeasible() const
+	{
+		return Failure == ETileGenFailure::Infeasible;
+	}
+
+	/** @return Human-readable summary of the report for logging. */
+	FString ToString() const;
+};
@@ -0,0 +1,46 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TileGen/TileGenParams.h"
+#include "TileMapSeed.generated.h"
+
+/**
+ * Compact description of a generated tile map. Rather than replicating every tile plan, servers
+ * can replicate a seed and have clients regenerate the same tile map locally. The hashes let the
+ * client verify that its tileset and its regenerated map match those on the server.
+ */
+USTRUCT(BlueprintType)
+struct IOTATILE_API FTileMapSeed
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Parameters used to generate the tile map, including the original seed. */
+	UPROPERTY(BlueprintReadOnly)
+	FTileGenParams Params;
+
+	/** Hash of the tile data used to generate the tile map. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 TilesetHash = 0;
+
+	/** Hash of the tile plans in the generated tile map. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 MapHash = 0;
+
+	/** Budget check at which the generation budget ran out. Zero if it never ran out. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 BudgetCutoff = 0;
+
+	/** Server map index used to ensure safe replication. Zero if the seed is empty. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 MapIndex = 0;
+
+	/** @return True if the seed describes a generated tile map. */
+	bool IsValid() const
+	{
+		return 0 < MapIndex;
+	}
+};
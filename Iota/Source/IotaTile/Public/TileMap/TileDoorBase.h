@@ -23,6 +23,18 @@ public:
 
 	ATileDoorBase();
 
+	/** Registers the door index and fallback door state for replication. */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Disables the fallback door state while the batched door state is available. */
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	/** Registers the door with the tile subsystem and synchronizes its batched state. */
+	virtual void BeginPlay() override;
+
+	/** Unregisters the door from the tile subsystem. */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/** Updates the general door sliding value. */
 	virtual void Tick(float DeltaTime) override;
 
@@ -102,6 +114,29 @@ public:
 	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = true))
 	void SetSealed(bool bSealed);
 
+	/**
+	 * Applies lock and seal state received through the batched door state on the tile map
+	 * component. Notifies Blueprints only if the state has changed.
+	 *
+	 * @param bLocked New door lock state.
+	 * @param bSealed New door seal state.
+	 */
+	void ApplyDoorState(bool bLocked, bool bSealed);
+
+	/**
+	 * Unregisters the door from the tile subsystem and clears its door index. Door indices
+	 * restart with each map, so doors of a retired map must not publish their state into the
+	 * door states of the map that replaced it.
+	 */
+	void ReleaseDoorIndex();
+
+	/**
+	 * Index of the door within the replicated door states of the tile map component. Doors
+	 * spawned outside a tile map graph have no index and do not replicate their state.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category = "DoorState", Replicated)
+	int32 DoorIndex = INDEX_NONE;
+
 	/** Portal dimensions the door is meant to fit within. */
 	UPROPERTY(BlueprintReadOnly, Category = "AssetID", EditDefaultsOnly)
 	FIntPoint DoorSize = FIntPoint(4, 3);
@@ -110,16 +145,38 @@ public:
 	UPROPERTY(BlueprintSetter = SetSlideDuration, Category = "DoorSettings", EditAnywhere)
 	float DoorSlideDuration = 1;
 
-	/** Door lock state. While true, the door will close automatically. */
-	UPROPERTY(BlueprintSetter = SetLocked, Category = "DoorSettings", EditAnywhere)
+	/**
+	 * Door lock state. While true, the door will close automatically. Replicates directly only if
+	 * the door cannot use the batched door state on the tile map component.
+	 */
+	UPROPERTY(BlueprintSetter = SetLocked, Category = "DoorSettings", EditAnywhere, ReplicatedUsing = OnRep_DoorState)
 	bool bIsLocked = false;
 
-	/** Door seal state. While true, the door becomes locked shut. */
-	UPROPERTY(BlueprintSetter = SetSealed, Category = "DoorSettings", EditAnywhere)
+	/**
+	 * Door seal state. While true, the door becomes locked shut. Replicates directly only if the
+	 * door cannot use the batched door state on the tile map component.
+	 */
+	UPROPERTY(BlueprintSetter = SetSealed, Category = "DoorSettings", EditAnywhere, ReplicatedUsing = OnRep_DoorState)
 	bool bIsSealed = false;
 
 private:
 
+	/** Notifies Blueprints when the fallback door state replicates. */
+	UFUNCTION()
+	void OnRep_DoorState();
+
+	/** @return True if the door state replicates through the tile map component. */
+	bool IsStateBatched() const;
+
+	/**
+	 * Wakes the door for a single replication update when its fallback state changes on the
+	 * server. The door returns to dormancy once the update has been sent.
+	 */
+	void FlushDoorState();
+
+	/** Writes the door state into the tile map component on the server. */
+	void PublishDoorState() const;
+
 	/** Door base component used as the door's pivot during placement. */
 	UPROPERTY(BlueprintReadOnly, Category = "Components", VisibleAnywhere, meta = (AllowPrivateAccess = true))
 	TObjectPtr<USceneComponent> DoorBaseComponent;
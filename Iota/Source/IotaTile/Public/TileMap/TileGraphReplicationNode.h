@@ -0,0 +1,129 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "IotaCore/GraphBase.h"
+#include "TileGraphReplicationNode.generated.h"
+
+class FTileMapGraph;
+
+/**
+ * Replication graph node that spatializes actors by tile map graph distance. Actors are bucketed
+ * by the tile containing them, and each connection only gathers actors within a fixed number of
+ * doors from the tile its viewer stands in. Graph distance is a far better proxy for visibility
+ * than Euclidean distance inside tile maps, so route spatialized actors to this node in place of
+ * a grid spatialization node.
+ *
+ * Actors outside every tile, and all actors while no tile map graph exists, are gathered for every
+ * connection. Viewers outside every tile gather all actors.
+ */
+UCLASS()
+class IOTATILE_API UTileGraphReplicationNode : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+
+	UTileGraphReplicationNode();
+
+	/** Adds the actor to the bucket of the tile containing it. */
+	virtual void NotifyAddNetworkActor(const FNetworkActorInfo& ActorInfo) override;
+
+	/** Removes the actor from its tile bucket. */
+	virtual bool NotifyRemoveNetworkActor(const FNetworkActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+
+	/** Removes every actor from the node. */
+	virtual void NotifyResetAllNetworkActors() override;
+
+	/** Moves actors that have crossed into another tile, and rebuilds buckets for new maps. */
+	virtual void PrepareForReplication() override;
+
+	/** Gathers the actor buckets of every tile near the connection viewers. */
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	/** Maximum number of doors between a viewer tile and a relevant actor tile. */
+	UPROPERTY()
+	int32 HopRadius = 2;
+
+	/**
+	 * Distance an actor outside every tile must move before it is searched for again. Searches for
+	 * such actors test every tile, so actors parked outside the map are not searched every frame.
+	 */
+	UPROPERTY()
+	float LooseRescanDistance = 100.0f;
+
+private:
+
+	/**
+	 * Returns the tiles within the hop radius of the given tile, computing and caching them on
+	 * first use. The cache is cleared whenever the tile map graph changes.
+	 *
+	 * @param Graph Active tile map graph.
+	 * @param TileIndex Graph index of the center tile.
+	 * @return Graph indices of every tile within the hop radius, including the center tile.
+	 */
+	const TArray<int32>& GetNeighborhood(const FTileMapGraph& Graph, int32 TileIndex);
+
+	/**
+	 * Finds the tile containing the actor, or INDEX_NONE if there is none.
+	 *
+	 * @param Actor Actor to locate.
+	 * @param HintIndex Graph index of the tile most likely to contain the actor, if known.
+	 * @return Graph index of the containing tile.
+	 */
+	int32 FindActorTile(const AActor* Actor, int32 HintIndex = INDEX_NONE) const;
+
+	/**
+	 * Returns the actor bucket for the given tile.
+	 *
+	 * @param TileIndex Graph index of the tile, or INDEX_NONE for actors outside every tile.
+	 * @return Actor list for the tile.
+	 */
+	FActorRepListRefView& GetBucket(int32 TileIndex);
+
+	/** Refreshes the tile map graph and rebuilds every bucket if the graph has changed. */
+	void RefreshGraph();
+
+	/**
+	 * Records where an actor outside every tile was last searched for, or forgets the actor once
+	 * it is inside a tile.
+	 *
+	 * @param Actor Tracked actor that was just searched for.
+	 * @param TileIndex Graph index of the containing tile, or INDEX_NONE if there is none.
+	 */
+	void TrackLooseActor(FActorRepListType Actor, int32 TileIndex);
+
+private:
+
+	/** Tile map graph used to bucket actors. */
+	TWeakPtr<const FTileMapGraph> CachedGraph;
+
+	/** Number of tiles in the cached graph when the buckets were built. */
+	int32 CachedSize = 0;
+
+	/** Tile containing each tracked actor. */
+	TMap<FActorRepListType, int32> ActorTiles;
+
+	/** Actors bucketed by containing tile, indexed by graph index. */
+	TArray<FActorRepListRefView> TileActors;
+
+	/** Actors outside every tile. */
+	FActorRepListRefView LooseActors;
+
+	/** Location at which each actor outside every tile was last searched for. */
+	TMap<FActorRepListType, FVector> LooseLocations;
+
+	/** Neighborhoods computed for each center tile. */
+	TMap<int32, TArray<int32>> Neighborhoods;
+
+	/** Scratch buffers for neighborhood searches. */
+	FGraphScratch Scratch;
+
+	/** Hop distance to each tile from the last neighborhood search. */
+	TArray<int32> HopDistances;
+
+	/** Last tile occupied by each connection viewer, used as a search hint. */
+	TMap<TObjectKey<UNetReplicationGraphConnection>, int32> ConnectionTiles;
+};
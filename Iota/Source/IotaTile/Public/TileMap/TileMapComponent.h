@@ -0,0 +1,185 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "TileData/TilePlan.h"
+#include "TileMapComponent.generated.h"
+
+class UTileMapComponent;
+
+/** Replicated tile map entry. */
+USTRUCT()
+struct IOTATILE_API FTileMapItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Tile plan to stream. */
+	UPROPERTY()
+	FTilePlan Plan;
+
+	/** Server map index of the map to which the tile belongs. */
+	UPROPERTY()
+	int32 MapIndex = 0;
+
+	/** Index of the tile within its map. */
+	UPROPERTY()
+	int32 PlanIndex = 0;
+
+	/**
+	 * Number of tiles in the map once the entry was added. Entries of the old map are only removed
+	 * after the new entries arrive, so clients cannot count the array to learn the map size.
+	 */
+	UPROPERTY()
+	int32 MapTileCount = 0;
+
+	/** Streams the tile on clients once it arrives. */
+	void PostReplicatedAdd(const struct FTileMapArray& InArraySerializer);
+};
+
+/** Delta-replicated array of tile map entries. Only new or changed entries are sent. */
+USTRUCT()
+struct IOTATILE_API FTileMapArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Replicated tile map entries. */
+	UPROPERTY()
+	TArray<FTileMapItem> Items;
+
+	/** Component that owns the array. */
+	UTileMapComponent* Owner = nullptr;
+
+	/** Delta serializes the array. */
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FTileMapItem, FTileMapArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FTileMapArray> : public TStructOpsTypeTraitsBase2<FTileMapArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true
+	};
+};
+
+/**
+ * Replicated carrier for the live tile map. Add the component to an always-relevant actor, such
+ * as the game state, and set the tile map on the server. Clients stream each tile as soon as its
+ * entry arrives, and tiles appended to the live map only replicate the new entries, so late
+ * joiners and incremental map growth cost only the delta.
+ */
+UCLASS(ClassGroup = "Tile", meta = (BlueprintSpawnableComponent))
+class IOTATILE_API UTileMapComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UTileMapComponent();
+
+	/** Binds the replicated tile map to the component. */
+	virtual void PostInitProperties() override;
+
+	/** Registers the replicated tile map and door states. */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Registers the component with the tile subsystem. */
+	virtual void BeginPlay() override;
+
+	/** Unregisters the component from the tile subsystem. */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/**
+	 * Replaces the replicated tile map and streams it in on the server. Must be called on the
+	 * server. Maps with an index no greater than the current index are ignored.
+	 *
+	 * @param NewTileMap Tile plan array to replicate.
+	 * @param NewMapIndex Server map index used to ensure safe replication.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Tile|TileMap")
+	void SetTileMap(const TArray<FTilePlan>& NewTileMap, int32 NewMapIndex);
+
+	/**
+	 * Replicates the tile map stored on the server tile subsystem. Equivalent to calling
+	 * SetTileMap with the results of UTileSubsystem::GetGraphTileMap.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Tile|TileMap")
+	void SetGraphTileMap();
+
+	/**
+	 * Appends tiles to the replicated tile map and streams them in on the server. Only the new
+	 * tiles are sent to clients. Appended tiles are streamed as level instances only, so any doors
+	 * they need must be spawned separately.
+	 *
+	 * @param NewTiles Tile plans to append to the live map.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Tile|TileMap")
+	void AppendTiles(const TArray<FTilePlan>& NewTiles);
+
+	/**
+	 * Stores the lock and seal state of a door in the batched door states. Must be called on the
+	 * server. Changing a door only replicates the bytes of the state array that changed.
+	 *
+	 * @param DoorIndex Index of the door to update.
+	 * @param bLocked New door lock state.
+	 * @param bSealed New door seal state.
+	 */
+	void SetDoorState(int32 DoorIndex, bool bLocked, bool bSealed);
+
+	/**
+	 * Reads the lock and seal state of a door from the batched door states.
+	 *
+	 * @param DoorIndex Index of the door to read.
+	 * @param bOutLocked Door lock state, if known.
+	 * @param bOutSealed Door seal state, if known.
+	 * @return True if the state of the door is known.
+	 */
+	bool GetDoorState(int32 DoorIndex, bool& bOutLocked, bool& bOutSealed) const;
+
+	/** @return Server map index of the replicated tile map, or zero if there is none. */
+	UFUNCTION(BlueprintPure, Category = "Tile|TileMap")
+	int32 GetMapIndex() const;
+
+private:
+
+	friend struct FTileMapItem;
+
+	/**
+	 * Streams a replicated tile into the client world, starting a new live map first if the tile
+	 * belongs to a newer map than the active one.
+	 *
+	 * @param Item Replicated tile map entry to stream.
+	 */
+	void StreamItem(const FTileMapItem& Item);
+
+	/** Applies changed door states to the registered client doors. */
+	UFUNCTION()
+	void OnRep_DoorStates();
+
+	/** Delta-replicated tile map entries. */
+	UPROPERTY(Replicated)
+	FTileMapArray TileMap;
+
+	/** Server map index of the replicated tile map. */
+	int32 MapIndex = 0;
+
+	/**
+	 * Batched door states, indexed by door index and packed four doors per byte. Each door uses
+	 * two bits, with the low bit holding the lock state and the high bit holding the seal state.
+	 */
+	UPROPERTY(ReplicatedUsing = OnRep_DoorStates)
+	TArray<uint8> DoorStates;
+
+	/** Door states last applied on the client, used to find changes. */
+	TArray<uint8> AppliedStates;
+};
@@ -3,7 +3,9 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "TileData/TileBound.h"
 #include "TileData/TilePlan.h"
+#include "TileData/TilePortal.h"
 #include "IotaCore/GraphBase.h"
 #include "TileMap/TileDoorBase.h"
 
@@ -18,12 +20,61 @@ struct IOTATILE_API FTileDoor
 	/** True if the door connects to a terminal. */
 	bool bTerminal = false;
 
+	/** Portal filled by the door, facing out of the child tile and into its parent. */
+	FTilePortal Portal;
+
+	/** Index of the door portal within the tile data of the child tile. */
+	int32 ChildPortal = INDEX_NONE;
+
+	/** Index of the door portal within the tile data of the parent tile. */
+	int32 ParentPortal = INDEX_NONE;
+
 	/** Cleans up the door actor. */
 	~FTileDoor();
 };
 
+/** Tracks a placed tile in the tile map graph. */
+struct IOTATILE_API FTileNode : public FTilePlan
+{
+	/** World space collision bounds of the tile. */
+	TArray<FTileBound> Bounds;
+
+	/** Walking distance between each pair of portals on the tile, in tile data portal order. */
+	TArray<float> PortalDistances;
+
+	/** Number of portals in the tile data. */
+	int32 NumPortals = 0;
+
+	/**
+	 * Defines a new tile node.
+	 *
+	 * @param InPlan Tile plan for the placed tile.
+	 * @param InBounds World space collision bounds of the placed tile.
+	 * @param InPortalDistances Walking distance between each pair of portals on the tile.
+	 * @param InNumPortals Number of portals in the tile data.
+	 */
+	FTileNode(const FTilePlan& InPlan, const TArray<FTileBound>& InBounds, const TArray<float>& InPortalDistances = TArray<float>(), int32 InNumPortals = 0);
+
+	/**
+	 * Returns the exported walking distance between two portals on the tile.
+	 *
+	 * @param From Tile data index of the first portal.
+	 * @param To Tile data index of the second portal.
+	 * @return Walking distance in world units, or a negative value if none was exported.
+	 */
+	float GetPortalDistance(int32 From, int32 To) const;
+
+	/**
+	 * Determines if the given world space point lies within any of the tile bounds.
+	 *
+	 * @param Point World space point to test.
+	 * @return True if the point is inside the tile.
+	 */
+	bool Contains(const FVector& Point) const;
+};
+
 /** Represents tile maps as undirected graphs where tiles are nodes and doors are edges. */
-class IOTATILE_API FTileMapGraph : public TGraphBase<FTilePlan, FTileDoor>
+class IOTATILE_API FTileMapGraph : public TGraphBase<FTileNode, FTileDoor>
 {
 
 public:
@@ -31,6 +82,9 @@ public:
 	/** Constructs a new map graph within the provided world context. */
 	FTileMapGraph(UWorld* InWorld);
 
+	/** Destroys the tile map graph along with all tracked door actors. */
+	virtual ~FTileMapGraph();
+
 	/** Empties the tile map graph and removes all tracked door actors. */
 	virtual void Empty() override;
 
@@ -55,6 +109,17 @@ public:
 	 */
 	void GetPlans(TArray<FTilePlan>& OutTilePlans) const;
 
+	/**
+	 * Finds the tile containing the given world space point. The hint tile and its neighbors are
+	 * tested first, so passing the last known tile of a moving point makes the search constant
+	 * time in the common case.
+	 *
+	 * @param Point World space point to locate.
+	 * @param HintIndex Graph index of the tile most likely to contain the point, if known.
+	 * @return Graph index of the containing tile, or INDEX_NONE if the point is outside the map.
+	 */
+	int32 FindTile(const FVector& Point, int32 HintIndex = INDEX_NONE) const;
+
 	/**
 	 * Requests a new door spawn. Door spawn requests will wait until the map graph is marked live,
 	 * at which point they will automatically spawn into the graph world context.
@@ -65,6 +130,23 @@ public:
 	 */
 	void RequestDoor(const TSubclassOf<ATileDoorBase>& DoorClass, const FTransform& DoorTransform, FTileDoor* OwnerEdge = nullptr);
 
+	/**
+	 * Stops the graph spawning doors and gathers its door actors for destruction. Every gathered
+	 * door gives up its door index immediately, so that a new map can reuse the indices while the
+	 * actors themselves are destroyed over several frames by RetireDoors.
+	 */
+	void BeginRetirement();
+
+	/**
+	 * Destroys the door actors tracked by the graph a few at a time, so that retiring a large map
+	 * does not destroy every door in a single frame. At least one door is destroyed per call. The
+	 * graph stops spawning door requests once retirement begins.
+	 *
+	 * @param EndTime Platform time after which no further doors should be destroyed.
+	 * @return True once every door actor has been destroyed.
+	 */
+	bool RetireDoors(double EndTime);
+
 private:
 
 	/** Graph world context. */
@@ -88,6 +170,15 @@ private:
 	/** Stores door spawn data so that doors can be spawned into the rest of the level. */
 	TArray<FTileDoorRequest> DoorRequests;
 
+	/** Number of door requests that have already been handled. */
+	int32 SpawnedRequests = 0;
+
 	/** True once the graph loads. Door requests will auto-spawn while this is true. */
 	bool bLiveGraph = false;
+
+	/** Door actors waiting to be destroyed by a graph in retirement. */
+	TArray<TWeakObjectPtr<ATileDoorBase>> RetiringDoors;
+
+	/** True once the graph begins retiring its doors. */
+	bool bRetiring = false;
 };
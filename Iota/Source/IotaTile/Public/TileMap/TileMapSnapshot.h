@@ -0,0 +1,169 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "TileData/TileBound.h"
+#include "TileData/TilePlan.h"
+#include "TileData/TilePortal.h"
+#include "IotaCore/GraphBase.h"
+
+class FTileMapGraph;
+
+/** Copy of a placed tile held by a tile map snapshot. */
+struct IOTATILE_API FTileSnapshotTile : public FTilePlan
+{
+	/** World space collision bounds of the tile. Empty if the bounds were not known. */
+	TArray<FTileBound> Bounds;
+
+	/**
+	 * Defines a new snapshot tile.
+	 *
+	 * @param InPlan Tile plan for the placed tile.
+	 * @param InBounds World space collision bounds of the placed tile.
+	 */
+	FTileSnapshotTile(const FTilePlan& InPlan, const TArray<FTileBound>& InBounds);
+
+	/** @return True if the world space point lies within any of the tile bounds. */
+	bool Contains(const FVector& Point) const;
+};
+
+/** Copy of a door held by a tile map snapshot. */
+struct IOTATILE_API FTileSnapshotDoor
+{
+	/** Portal filled by the door, facing out of the child tile and into its parent. */
+	FTilePortal Portal;
+
+	/** True if the door connects to a terminal. */
+	bool bTerminal = false;
+};
+
+/** Snapshot graph type, with tiles as nodes and doors as edges. */
+typedef TGraphBase<FTileSnapshotTile, FTileSnapshotDoor> FTileSnapshotGraph;
+
+/**
+ * Immutable copy of the topology and plans of a tile map. Snapshots hold no world references, and
+ * their graph adjacency is built before they are shared, so any number of threads may read one
+ * at once. Graph queries on a snapshot from other threads should use their own scratch buffers,
+ * such as FTileSnapshotGraph::GetThreadScratch.
+ *
+ * A snapshot is filled in once, finished, and then only ever handled through a pointer to const.
+ */
+class IOTATILE_API FTileMapSnapshot
+{
+
+public:
+
+	/**
+	 * Constructs an empty snapshot of the given map.
+	 *
+	 * @param InMapIndex Server map index of the map.
+	 */
+	FTileMapSnapshot(int32 InMapIndex);
+
+	/**
+	 * Adds a tile to the snapshot. Tiles must be added in plan index order.
+	 *
+	 * @param Plan Tile plan of the tile.
+	 * @param Bounds World space collision bounds of the tile, if known.
+	 */
+	void AddTile(const FTilePlan& Plan, const TArray<FTileBound>& Bounds = TArray<FTileBound>());
+
+	/**
+	 * Adds a door between a tile and its parent.
+	 *
+	 * @param ChildTile Plan index of the child tile.
+	 * @param ParentTile Plan index of the parent tile.
+	 * @param Door Door data to copy.
+	 */
+	void AddDoor(int32 ChildTile, int32 ParentTile, const FTileSnapshotDoor& Door = FTileSnapshotDoor());
+
+	/**
+	 * Adds every tile and door of a map graph to the snapshot.
+	 *
+	 * @param MapGraph Map graph to copy.
+	 */
+	void AddMapGraph(const FTileMapGraph& MapGraph);
+
+	/** Prepares the snapshot for reads from any thread. Nothing may be added afterwards. */
+	void Finish();
+
+	/** @return Server map index of the map. */
+	int32 GetMapIndex() const;
+
+	/** @return Number of tiles in the snapshot. */
+	int32 GetNumTiles() const;
+
+	/**
+	 * Returns a tile stored within the snapshot.
+	 *
+	 * @param Index Plan index of the tile.
+	 * @return Snapshot tile at the given index.
+	 */
+	const FTileSnapshotTile& GetTile(int32 Index) const;
+
+	/** @return Snapshot graph, with tiles as nodes and doors as edges. */
+	const FTileSnapshotGraph& GetGraph() const;
+
+	/**
+	 * Finds the tile containing the given world space point, testing the hint tile and its
+	 * neighbors first.
+	 *
+	 * @param Point World space point to locate.
+	 * @param HintIndex Plan index of the tile most likely to contain the point, if known.
+	 * @return Plan index of the containing tile, or INDEX_NONE if no tile bounds contain the point.
+	 */
+	int32 FindTile(const FVector& Point, int32 HintIndex = INDEX_NONE) const;
+
+private:
+
+	/** Server map index of the map. */
+	int32 MapIndex = INDEX_NONE;
+
+	/** Tiles as nodes and doors as edges. */
+	FTileSnapshotGraph Graph;
+
+	/** True once the snapshot has been finished. */
+	bool bFinished = false;
+};
+
+/**
+ * Publishes the current tile map snapshot to readers on any thread. A single writer on the game
+ * thread replaces the snapshot, and readers acquire a reference to it without taking a lock.
+ *
+ * The publisher keeps the current snapshot and the one before it in two slots, and counts the
+ * readers copying out of each slot. Before a slot is reused, the writer waits for the readers
+ * still copying out of it, which only takes as long as a reference count increment. Replaced
+ * snapshots are then freed as soon as the last reader releases its reference.
+ */
+class IOTATILE_API FTileMapSnapshotPublisher
+{
+
+public:
+
+	/**
+	 * Replaces the current snapshot. Must only be called from one thread at a time.
+	 *
+	 * @param Snapshot Finished snapshot to publish, or null to clear the current snapshot.
+	 */
+	void Publish(const TSharedPtr<const FTileMapSnapshot>& Snapshot);
+
+	/**
+	 * Acquires a reference to the current snapshot. Safe to call from any thread.
+	 *
+	 * @return Current snapshot, or null if none has been published.
+	 */
+	TSharedPtr<const FTileMapSnapshot> Acquire() const;
+
+private:
+
+	/** Current snapshot, in the slot selected by the epoch, and the snapshot before it. */
+	TSharedPtr<const FTileMapSnapshot> Slots[2];
+
+	/** Number of snapshots published so far. Its lowest bit selects the current slot. */
+	FThreadSafeCounter Epoch;
+
+	/** Number of readers copying out of each slot. */
+	mutable FThreadSafeCounter Readers[2];
+};
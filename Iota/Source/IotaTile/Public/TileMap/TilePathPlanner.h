@@ -0,0 +1,82 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IotaCore/GraphBase.h"
+
+class FTileMapGraph;
+
+/**
+ * Plans coarse routes across a tile map by searching over its doors rather than its navigation
+ * mesh. Doors are graph nodes, and each pair of doors on the same tile is joined by an edge
+ * weighted with the walking distance between their portals, as exported with the tile data. A
+ * route is the sequence of doors to pass through, so callers only need detailed navigation
+ * queries within the tile they are in and the next one along the route.
+ *
+ * Routes are cached per pair of start and goal tiles until the planner is rebuilt.
+ */
+class IOTATILE_API FTilePathPlanner
+{
+
+public:
+
+	/** Discards the door graph and every cached route. */
+	void Reset();
+
+	/**
+	 * Resets the planner and builds a door graph from the given map graph.
+	 *
+	 * @param MapGraph Map graph from which to read tiles, doors, and portal distances.
+	 */
+	void Build(const FTileMapGraph& MapGraph);
+
+	/** @return True if the planner holds no tiles. */
+	bool IsEmpty() const;
+
+	/**
+	 * Finds the cheapest sequence of doors leading from one tile to another, computing and caching
+	 * it on first use.
+	 *
+	 * @param StartTile Graph index of the tile to start in.
+	 * @param GoalTile Graph index of the tile to finish in.
+	 * @return Door indices along the route in order of travel, or null if there is no route. The
+	 *         route is empty if both tiles are the same, and stays valid until the next query.
+	 */
+	const TArray<int32>* FindRoute(int32 StartTile, int32 GoalTile);
+
+	/**
+	 * Returns the world space location of a door.
+	 *
+	 * @param Door Door index, as returned within a route.
+	 * @return Bottom center of the door portal.
+	 */
+	const FVector& GetDoorLocation(int32 Door) const;
+
+	/** @return Number of routes currently cached. */
+	int32 GetNumCachedRoutes() const;
+
+private:
+
+	/** Cached result of a route query. */
+	struct FTileRoute
+	{
+		/** Door indices along the route in order of travel. */
+		TArray<int32> Doors;
+
+		/** True if the goal tile can be reached from the start tile. */
+		bool bReachable = false;
+	};
+
+	/** Doors as nodes, holding door locations, joined by the walking distance across each tile. */
+	TGraphBase<FVector, float> DoorGraph;
+
+	/** Door indices on each tile, indexed by tile. */
+	TArray<TArray<int32>> TileDoors;
+
+	/** Routes computed so far, keyed by start and goal tile. */
+	TMap<FIntPoint, FTileRoute> Routes;
+
+	/** Scratch buffers for route searches. */
+	FGraphScratch Scratch;
+};
@@ -0,0 +1,139 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TileData/TilePortal.h"
+
+class FTileMapGraph;
+
+/**
+ * Computes a conservative potentially visible set (PVS) for each tile in a tile map, using the
+ * portal rectangles that join the tiles. A tile is visible from another tile if some line passes
+ * from the source tile through every portal along the chain between them. The computation runs
+ * entirely on the CPU with no world access, so it can be built and queried headless.
+ *
+ * The visibility test is conservative: it only ever reports extra tiles as visible, never fewer.
+ * Each portal chain is checked against the portal it began with and the portal it last passed
+ * through, and the portals between them are ignored.
+ */
+class IOTATILE_API FTilePortalVisibility
+{
+
+public:
+
+	/**
+	 * Discards all portals and visibility results and prepares the given number of tiles.
+	 *
+	 * @param InNumTiles Number of tiles in the tile map.
+	 */
+	void Reset(int32 InNumTiles = 0);
+
+	/**
+	 * Adds a portal joining two tiles. The portal direction must point out of the first tile and
+	 * into the second, and the portal location must sit at the bottom center of its rectangle, as
+	 * with portals produced by the generator.
+	 *
+	 * @param FromTile Index of the tile the portal direction points out of.
+	 * @param ToTile Index of the tile the portal direction points into.
+	 * @param Portal World space portal rectangle.
+	 */
+	void AddPortal(int32 FromTile, int32 ToTile, const FTilePortal& Portal);
+
+	/**
+	 * Resets the visibility data and adds one portal for each door in the given map graph.
+	 *
+	 * @param MapGraph Map graph from which to read tiles and door portals.
+	 */
+	void Build(const FTileMapGraph& MapGraph);
+
+	/** Computes the potentially visible set of every tile from the portals added so far. */
+	void Compute();
+
+	/** @return True if no visibility has been computed. */
+	bool IsEmpty() const;
+
+	/** @return Number of tiles tracked by the visibility data. */
+	int32 GetNumTiles() const;
+
+	/**
+	 * Determines if a tile might be visible from anywhere within another tile. Tiles outside the
+	 * computed range are always reported as visible.
+	 *
+	 * @param FromTile Index of the tile containing the viewer.
+	 * @param ToTile Index of the tile to test.
+	 * @return True if the tile is in the potentially visible set of the viewer tile.
+	 */
+	bool IsVisible(int32 FromTile, int32 ToTile) const;
+
+private:
+
+	/** Portal rectangle with its corners and plane precomputed, oriented for travel. */
+	struct FPortalQuad
+	{
+		/** World space corners of the rectangle, in winding order. */
+		FVector Corners[4];
+
+		/** Plane of the rectangle. Its normal points in the direction of travel. */
+		FPlane Plane;
+
+		/** @return Copy of the rectangle oriented for travel in the opposite direction. */
+		FPortalQuad Reversed() const;
+	};
+
+	/** Connection from one tile to another through a portal. */
+	struct FPortalLink
+	{
+		/** Index of the tile on the far side of the portal. */
+		int32 Tile = INDEX_NONE;
+
+		/** Index of the portal within the portal array. */
+		int32 Portal = INDEX_NONE;
+
+		/** True if the link travels against the stored portal direction. */
+		bool bReverse = false;
+	};
+
+	/**
+	 * Marks every tile visible from the source through further portals of the given tile.
+	 *
+	 * @param Source Index of the tile whose visible set is being computed.
+	 * @param Tile Index of the tile the chain has just entered.
+	 * @param First First portal in the chain, leaving the source tile.
+	 * @param Last Last portal in the chain, entering the given tile.
+	 * @param Planes Planes separating the first and last portals, facing the last portal.
+	 * @param Path Tiles visited by the chain so far.
+	 */
+	void ComputeChain(int32 Source, int32 Tile, const FPortalQuad& First, const FPortalQuad& Last, const TArray<FPlane>& Planes, TArray<int32>& Path);
+
+	/** @return Oriented portal rectangle for the given link. */
+	FPortalQuad GetQuad(const FPortalLink& Link) const;
+
+	/** @return True if any corner of the rectangle lies strictly in front of the plane. */
+	static bool IsInFront(const FPortalQuad& Quad, const FPlane& Plane);
+
+	/** @return True if some corner of the rectangle lies on the front side of every plane. */
+	static bool PassesPlanes(const FPortalQuad& Quad, const TArray<FPlane>& Planes);
+
+	/**
+	 * Finds the planes that separate two portal rectangles, each through an edge of one rectangle
+	 * and a corner of the other. Every line passing through both rectangles lies in front of all
+	 * of these planes past the second rectangle.
+	 *
+	 * @param A First portal rectangle.
+	 * @param B Second portal rectangle.
+	 * @param OutPlanes Separating planes, oriented with the second rectangle in front.
+	 */
+	static void FindSeparatingPlanes(const FPortalQuad& A, const FPortalQuad& B, TArray<FPlane>& OutPlanes);
+
+private:
+
+	/** Portal rectangles, oriented along the direction they were added with. */
+	TArray<FPortalQuad> Portals;
+
+	/** Portal links leaving each tile, indexed by tile. */
+	TArray<TArray<FPortalLink>> Links;
+
+	/** Potentially visible set of each tile, indexed by tile. */
+	TArray<TBitArray<>> VisibleSets;
+};
@@ -0,0 +1,45 @@
+// Copyright Sydney Fonderie, 2023. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "TileProxyActor.generated.h"
+
+struct FTileBound;
+class UInstancedStaticMeshComponent;
+
+/**
+ * Renders cheap stand-ins for tiles whose full levels are not visible, drawing one instanced box
+ * for each tile collision bound. The actor is local to each machine and never replicates.
+ */
+UCLASS(NotPlaceable, Transient)
+class IOTATILE_API ATileProxyActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	ATileProxyActor();
+
+	/**
+	 * Replaces the drawn proxies with one box for each of the given tile bounds.
+	 *
+	 * @param Bounds World space tile bounds to draw.
+	 */
+	void SetBounds(const TArray<const FTileBound*>& Bounds);
+
+private:
+
+	/** Instanced box component used to draw every proxy in a single batch. */
+	UPROPERTY(BlueprintReadOnly, Category = "TileProxy", VisibleAnywhere, meta = (AllowPrivateAccess = true))
+	TObjectPtr<UInstancedStaticMeshComponent> BoxComponent;
+
+public:
+
+	/** @return Instanced box component used to draw the proxies. */
+	UInstancedStaticMeshComponent* GetBoxComponent() const
+	{
+		return BoxComponent;
+	}
+};
@@ -4,26 +4,49 @@
 
 #include "CoreMinimal.h"
 #include "Subsystems/WorldSubsystem.h"
+#include "TileData/TileBound.h"
+#include "TileData/TileMapPack.h"
+#include "TileGen/TileMapSeed.h"
+#include "TileMap/TileMapSnapshot.h"
 #include "TileSubsystem.generated.h"
 
+class ATileDoorBase;
+class ATileProxyActor;
 class FTileGenAction;
 class FTileMapGraph;
+class FTileMapSnapshot;
+class FTileMapSnapshotPublisher;
+class FTilePathPlanner;
+class FTilePortalVisibility;
+class UTileMapComponent;
 class UTilePlanStream;
 
 struct FTileGenParams;
 struct FTilePlan;
 
-/** Blueprint-accessible delegate used for generator events. */
-DECLARE_DYNAMIC_DELEGATE(FGeneratorDelegate);
+/**
+ * Blueprint-accessible delegate used for generator events. Success is false when the generator
+ * gave up without producing a map, in which case the previous map is still active.
+ */
+DECLARE_DYNAMIC_DELEGATE_OneParam(FGeneratorDelegate, bool, bSuccess);
+
+/** Blueprint-accessible delegate broadcast when a live tile map becomes usable. */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FTileMapReadyDelegate, int32, MapIndex);
 
 /** Public interface for tile map generation features. */
 UCLASS()
-class IOTATILE_API UTileSubsystem : public UWorldSubsystem
+class IOTATILE_API UTileSubsystem : public UTickableWorldSubsystem
 {
 	GENERATED_BODY()
 
 public:
 
+	/** Starts streaming queued tiles, nearest to the local player first. */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat ID for the subsystem tick. */
+	virtual TStatId GetStatId() const override;
+
 	/**
 	 * Determines if the subsystem has the authority needed to generate tile maps. Authority is
 	 * conferred via the subsystem world - if the world is running on a server, then it has the
@@ -35,8 +58,9 @@ public:
 
 	/**
 	 * Generates a new tile map from the given parameters and stores the results on the subsystem.
-	 * Invokes the provided delegate once the tile map has been stored. In order to generate a new
-	 * map, the subsystem must call this method from a server.
+	 * Invokes the provided delegate once the tile map has been stored, or once the generator has
+	 * given up because the tileset is infeasible or the generation budget ran out. In order to
+	 * generate a new map, the subsystem must call this method from a server.
 	 *
 	 * @param Parameters Generation parameters used to create the new tile map.
 	 * @param OnComplete Delegate invoked when the generator action completes.
@@ -70,11 +94,346 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Tile|Subsystem")
 	void SetLiveTileMap(const TArray<FTilePlan>& NewTileMap, int32 MapIndex);
 
+	/**
+	 * Begins streaming a new tile map into the subsystem world, discarding the active map. Tiles
+	 * can then be added to the new map one at a time as they become available, which allows maps
+	 * to stream in while they are still being replicated. Calls with a map index no greater than
+	 * the active index are ignored.
+	 *
+	 * @param MapIndex Server map index used to ensure safe replication.
+	 * @param ExpectedTiles Number of tiles expected in the new map, used to reserve memory.
+	 * @return True if the new map became the active map.
+	 */
+	bool BeginLiveTileMap(int32 MapIndex, int32 ExpectedTiles = 0);
+
+	/**
+	 * Raises the number of tiles expected in the active map, such as when tiles are appended to
+	 * it. The map is not reported as ready until that many tiles have been added. Calls for any map
+	 * other than the active map are ignored.
+	 *
+	 * @param MapIndex Server map index of the map to which the tiles belong.
+	 * @param ExpectedTiles Total number of tiles expected in the map.
+	 */
+	void ExpectLiveTiles(int32 MapIndex, int32 ExpectedTiles);
+
+	/**
+	 * Queues a single tile to stream into the active tile map. The plan index must be unique within
+	 * the map and identical on every machine, as it is used to name the level instance. Tiles
+	 * belonging to any map other than the active map are ignored.
+	 *
+	 * Queued tiles stream in order of graph distance from the local player tile (or the map root
+	 * if there is no local player), with a limited number of loads in flight at once, so that the
+	 * area around the player becomes playable long before the rest of the map has loaded.
+	 *
+	 * @param TilePlan Tile plan to stream into the world.
+	 * @param MapIndex Server map index of the map to which the tile belongs.
+	 * @param PlanIndex Index of the tile within its map.
+	 */
+	void AddLiveTile(const FTilePlan& TilePlan, int32 MapIndex, int32 PlanIndex);
+
+	/** @return Server index of the tile map currently streamed into the world. */
+	int32 GetActiveIndex() const;
+
+	/**
+	 * Determines if the active tile map is ready to use - that is, every tile in the ready set has
+	 * loaded and, unless culled or evicted, become visible. The ready set covers every tile within
+	 * IotaTile.ReadyDistance doors of a focus tile, or every tile if the distance is negative.
+	 *
+	 * @return True if the active tile map is ready.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Tile|Subsystem")
+	bool IsTileMapReady() const;
+
+	/**
+	 * Returns the streaming latency of a tile in the active map, measured from the moment its
+	 * stream was requested.
+	 *
+	 * @param PlanIndex Index of the tile within the active map.
+	 * @param OutLoadSeconds Seconds until the tile level loaded, or negative if it has not loaded.
+	 * @param OutVisibleSeconds Seconds until the tile level became visible, or negative if it has not.
+	 * @return True if the tile has been requested.
+	 */
+	UFUNCTION(BlueprintPure = false, Category = "Tile|Subsystem")
+	bool GetTileLatency(int32 PlanIndex, float& OutLoadSeconds, float& OutVisibleSeconds) const;
+
+	/** Broadcast once per live tile map when it becomes ready to use. */
+	UPROPERTY(BlueprintAssignable, Category = "Tile|Subsystem")
+	FTileMapReadyDelegate OnTileMapReady;
+
+	/** @return Tile map graph generated on the server, if one exists. */
+	TSharedPtr<const FTileMapGraph> GetMapGraph() const;
+
+	/**
+	 * Returns the snapshot of the active tile map. Snapshots are published once every expected
+	 * tile of a new map has arrived, and again whenever tiles are appended, and hold its plans and
+	 * topology, along with its bounds and portals where known. The snapshot is cleared as soon as
+	 * a new map begins, so readers never mistake the old map for the new one.
+	 *
+	 * @return Current tile map snapshot, or null if the active map has not fully arrived.
+	 */
+	TSharedPtr<const FTileMapSnapshot> GetMapSnapshot() const;
+
+	/**
+	 * Returns the publisher through which tile map snapshots are released. Async tasks should
+	 * capture the publisher on the game thread and acquire snapshots from it on their own thread,
+	 * as the subsystem itself may only be used on the game thread.
+	 *
+	 * @return Snapshot publisher of the subsystem.
+	 */
+	TSharedRef<FTileMapSnapshotPublisher> GetSnapshotPublisher();
+
+	/**
+	 * Finds a route between two world space points across the active tile map, planned over its
+	 * doors rather than its navigation mesh. Routes are only available on the server, where the
+	 * map graph is known, and coarse routes are cached per pair of start and goal tiles.
+	 *
+	 * With refinement, the legs through the start tile and the next tile along the route follow
+	 * the navigation mesh, and later legs run straight from door to door. Callers moving along a
+	 * long route should query again as they enter each new tile.
+	 *
+	 * @param Start World space point to start from.
+	 * @param Goal World space point to finish at.
+	 * @param OutWaypoints Points to visit in order, ending at the goal.
+	 * @param bRefine True to follow the navigation mesh through the start and next tiles.
+	 * @return True if both points lie within the tile map and a route joins them.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Tile|Subsystem")
+	bool FindTileRoute(const FVector& Start, const FVector& Goal, TArray<FVector>& OutWaypoints, bool bRefine = true);
+
+	/**
+	 * Registers the replicated tile map component for the world. Doors publish and receive their
+	 * batched state through this component.
+	 *
+	 * @param NewMapComponent Tile map component to register, or null to clear it.
+	 */
+	void RegisterMapComponent(UTileMapComponent* NewMapComponent);
+
+	/** @return Replicated tile map component registered with the subsystem, if any. */
+	UTileMapComponent* GetMapComponent() const;
+
+	/**
+	 * Registers a door actor under its door index so that batched door state can be applied to it.
+	 *
+	 * @param Door Door actor to register.
+	 */
+	void RegisterDoor(ATileDoorBase* Door);
+
+	/**
+	 * Unregisters a door actor, provided it is still the door registered under its index.
+	 *
+	 * @param Door Door actor to unregister.
+	 */
+	void UnregisterDoor(ATileDoorBase* Door);
+
+	/**
+	 * Finds the door actor registered under the given door index.
+	 *
+	 * @param DoorIndex Door index to look up.
+	 * @return Door actor with the given index, or null if there is none.
+	 */
+	ATileDoorBase* FindDoor(int32 DoorIndex) const;
+
+	/**
+	 * Returns the generated tile map currently stored on the subsystem in a packed form that
+	 * replicates far more compactly than the plain tile plan array. If the subsystem does not
+	 * contain a complete tile map, the returned pack will be empty.
+	 *
+	 * @param OutPack Packed tile map stored on the subsystem, if one exists.
+	 */
+	UFUNCTION(BlueprintPure = false, Category = "Tile|Subsystem")
+	void GetPackedTileMap(FTileMapPack& OutPack) const;
+
+	/**
+	 * Streams a packed tile map into the subsystem world. Equivalent to calling SetLiveTileMap
+	 * with the plans and map index stored in the pack.
+	 *
+	 * @param Pack Packed tile map to stream into the world.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Tile|Subsystem")
+	void SetPackedTileMap(const FTileMapPack& Pack);
+
+	/**
+	 * Returns a seed describing the generated tile map currently stored on the subsystem. Seeds
+	 * replicate in a few dozen bytes regardless of map size, so they are preferable to the full
+	 * tile plan array when clients share the server tileset. If the subsystem does not contain a
+	 * complete tile map, the returned seed will be empty.
+	 *
+	 * @param OutSeed Seed describing the generated tile map, if one exists.
+	 */
+	UFUNCTION(BlueprintPure = false, Category = "Tile|Subsystem")
+	void GetSeededTileMap(FTileMapSeed& OutSeed) const;
+
+	/**
+	 * Regenerates the tile map described by a server seed on a client, then streams it into the
+	 * subsystem world as if SetLiveTileMap had been called with the server tile map. If either
+	 * the client tileset or the regenerated map does not match the server hashes, the map will
+	 * not be streamed. Seeds with a map index no greater than the active index are ignored.
+	 *
+	 * @param Seed Server seed describing the tile map to regenerate.
+	 * @param OnComplete Delegate invoked once the regenerated map has been streamed in or rejected.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Tile|Subsystem")
+	void SetSeededTileMap(const FTileMapSeed& Seed, const FGeneratorDelegate& OnComplete);
+
 private:
 
+	/**
+	 * Replaces the active generator action with a new one using the given parameters.
+	 *
+	 * @param Parameters Generation parameters used to create the new tile map.
+	 * @param OnComplete Delegate invoked when the generator action completes.
+	 * @param BudgetCutoff Recorded budget cutoff to replay, or INDEX_NONE for a new tile map.
+	 */
+	void StartGenerator(const FTileGenParams& Parameters, const FGeneratorDelegate& OnComplete, int32 BudgetCutoff = INDEX_NONE);
+
 	/** Invoked when a generator action completes. */
 	void NotifyGeneratorComplete();
 
+	/**
+	 * Releases a generator action that can never produce a valid map, restores the map graph it
+	 * replaced, and reports the failure to the completion delegate.
+	 */
+	void AbandonGenerator();
+
+	/** Verifies and streams in a tile map regenerated from a server seed. */
+	void NotifySeedComplete();
+
+	/** @return True if the active generator action streams tiles while it generates. */
+	bool IsPipelining() const;
+
+	/**
+	 * Streams in the tile plans committed by the generator since the last update, hidden. Plans
+	 * from a newer epoch discard every stream started for an older one.
+	 */
+	void UpdatePipeline();
+
+	/**
+	 * Moves the pipelined stream for the given tile into the active map and makes it visible.
+	 *
+	 * @param PlanIndex Index of the tile within the active map.
+	 * @return True if a pipelined stream was adopted.
+	 */
+	bool AdoptPipelineStream(int32 PlanIndex);
+
+	/** Releases every pipelined stream that has not been adopted by the active map. */
+	void ReleasePipelineStreams();
+
+	/**
+	 * Queues a stream to be unloaded and removed once fewer than IotaTile.MaxConcurrentUnloads
+	 * retired levels are still unloading.
+	 *
+	 * @param Stream Stream to retire.
+	 */
+	void RetireStream(UTilePlanStream* Stream);
+
+	/** Moves the previous map graph into retirement once the map replacing it has gone live. */
+	void RetirePreviousGraph();
+
+	/**
+	 * Tears down retiring map graphs under the per-frame retirement budget, and releases retiring
+	 * streams a few at a time. Door actors are destroyed before any stream is released, so that
+	 * doors never outlive the tile levels they sit in by more than a few frames.
+	 */
+	void UpdateRetirement();
+
+	/**
+	 * Streams a tile level instance and sets its load priority from its graph distance.
+	 *
+	 * @param TilePlan Tile plan to stream into the world.
+	 * @param PlanIndex Index of the tile within the active map.
+	 */
+	void StreamTile(const FTilePlan& TilePlan, int32 PlanIndex);
+
+	/** @return View locations of every local player. */
+	TArray<FVector> FindViewLocations() const;
+
+	/**
+	 * Determines if any local player has moved far enough since the focus tiles were last found
+	 * that they may have crossed into another tile.
+	 *
+	 * @param ViewLocations Current view locations of every local player.
+	 * @return True if the focus tiles should be found again.
+	 */
+	bool HasViewMoved(const TArray<FVector>& ViewLocations) const;
+
+	/**
+	 * Finds the live tiles containing the given view locations.
+	 *
+	 * @param ViewLocations View locations of every local player.
+	 * @return Sorted indices of the live tiles containing local players, or the map root.
+	 */
+	TArray<int32> FindFocusTiles(const TArray<FVector>& ViewLocations) const;
+
+	/**
+	 * Finds the live tile containing the given world location. Loaded tiles are matched by their
+	 * level bounds, and other tiles by their nearest origin.
+	 *
+	 * @param Location World location to locate.
+	 * @return Index of the containing tile, or INDEX_NONE if there are no live tiles.
+	 */
+	int32 FindTileAt(const FVector& Location) const;
+
+	/**
+	 * Computes the level bounds of newly loaded tiles. Does nothing once every stream that should
+	 * be loaded has its bounds, until another stream starts loading.
+	 *
+	 * @return True if the bounds of any tile were computed.
+	 */
+	bool CacheTileBounds();
+
+	/** Recomputes the graph distance from the nearest focus tile to every live tile. */
+	void UpdateTileDistances();
+
+	/** Releases old streams kept warm for new streams that have finished loading. */
+	void ReleaseWarmSources();
+
+	/** Releases every old stream that has not been matched with a new stream. */
+	void ReleaseRetainedStreams();
+
+	/** Unloads tiles far from every local player and reloads tiles near them, on clients only. */
+	void UpdateEviction();
+
+	/**
+	 * Hides loaded tiles that are outside the potentially visible set of every focus tile, and
+	 * shows them again once they come back into view. Only tiles with portal data are culled.
+	 */
+	void UpdatePortalCulling();
+
+	/**
+	 * Draws box proxies for tiles that have collision bounds but no visible level, skipping tiles
+	 * outside the potentially visible set of every focus tile.
+	 */
+	void UpdateTileProxies();
+
+	/** Records tile load and visibility times and broadcasts readiness once the ready set is usable. */
+	void UpdateReadiness();
+
+	/**
+	 * Publishes a snapshot of the live tiles. Tiles covered by the live map graph are copied from
+	 * the graph, and any others only carry their plans, known bounds, and parent links.
+	 */
+	void PublishMapSnapshot();
+
+	/**
+	 * Determines if a queued tile may start streaming given the eviction distance and the memory
+	 * budget.
+	 *
+	 * @param PlanIndex Index of the tile within the active map.
+	 * @return True if the tile may start streaming.
+	 */
+	bool CanStreamTile(int32 PlanIndex) const;
+
+	/** @return True if client memory use exceeds the tile memory budget. */
+	bool IsOverMemoryBudget() const;
+
+	/**
+	 * Returns the graph distance from the nearest focus tile to the given tile.
+	 *
+	 * @param PlanIndex Index of the tile within the active map.
+	 * @return Number of doors between the tiles, or MAX_int32 if the tile is unreachable.
+	 */
+	int32 GetTileDistance(int32 PlanIndex) const;
+
 private:
 
 	/** Tracks the active generator action. */
@@ -86,13 +445,152 @@ private:
 	/** Stores the active tile map as a graph structure. */
 	TSharedPtr<FTileMapGraph> MapGraph;
 
+	/** Live map graph replaced by a map that has not gone live yet. Its doors stay in the world. */
+	TSharedPtr<FTileMapGraph> PreviousGraph;
+
+	/** Portal visibility computed for the active tile map, if its portals are known. */
+	TSharedPtr<FTilePortalVisibility> PortalVisibility;
+
+	/** Door route planner for the active tile map, if its map graph is known. */
+	TSharedPtr<FTilePathPlanner> PathPlanner;
+
+	/** Publishes tile map snapshots to readers on other threads. */
+	TSharedPtr<FTileMapSnapshotPublisher> SnapshotPublisher;
+
+	/** World space collision bounds of each live tile, indexed by plan index, if they are known. */
+	TArray<TArray<FTileBound>> TileBounds;
+
+	/** Door into each live tile from its parent, indexed by plan index, if the portals are known. */
+	TArray<FTileSnapshotDoor> TileDoors;
+
+	/** Sorted indices of the tiles currently drawn as proxies. */
+	TArray<int32> ProxyTiles;
+
+	/** Local actor that draws the tile proxies. Spawned on first use. */
+	UPROPERTY()
+	TObjectPtr<ATileProxyActor> ProxyActor;
+
+	/** Map graphs whose door actors are being torn down over several frames. */
+	TArray<TSharedPtr<FTileMapGraph>> RetiringGraphs;
+
+	/** Streams waiting to be unloaded and removed over several frames, oldest first. */
+	UPROPERTY()
+	TArray<TObjectPtr<UTilePlanStream>> RetiringStreams;
+
+	/** Released streams whose levels have not yet left the world. */
+	UPROPERTY()
+	TArray<TObjectPtr<UTilePlanStream>> UnloadingStreams;
+
 	/** Tracks the number of generated tile maps produced by the subsystem. */
 	int32 MapCount = 0;
 
+	/** Seed describing the most recent tile map generated by the subsystem. */
+	FTileMapSeed LastSeed;
+
+	/** Server seed being regenerated by the active generator action, if any. */
+	TOptional<FTileMapSeed> PendingSeed;
+
 	/** Tracks all tile level streams active in the current world. */
 	UPROPERTY()
 	TArray<TObjectPtr<UTilePlanStream>> ActiveStreams;
 
+	/**
+	 * Loaded streams from the previous map, kept until a stream of the new map claims their level
+	 * or the new map has finished queueing its streams.
+	 */
+	UPROPERTY()
+	TArray<TObjectPtr<UTilePlanStream>> RetainedStreams;
+
+	/**
+	 * Streams started for tiles committed by the generator before the map is complete, indexed by
+	 * plan index. Null for tiles not yet committed or already adopted.
+	 */
+	UPROPERTY()
+	TArray<TObjectPtr<UTilePlanStream>> PipelineStreams;
+
+	/** Map index under which the pipelined streams are named, or INDEX_NONE if there are none. */
+	int32 PipelineIndex = INDEX_NONE;
+
+	/**
+	 * Map count when the active generator action started. Pipelined maps are indexed by this count
+	 * plus their epoch, so that every attempt names its streams uniquely.
+	 */
+	int32 PipelineBase = 0;
+
 	/** Tracks the server index of the active tile map. */
 	int32 ActiveIndex = 0;
+
+	/** Tile waiting to be streamed into the active map. */
+	struct FPendingTile
+	{
+		FTilePlan Plan;
+		int32 PlanIndex = 0;
+	};
+
+	/** Tiles waiting to be streamed into the active map, sorted farthest first. */
+	TArray<FPendingTile> PendingTiles;
+
+	/** Parent index of each live tile, indexed by plan index. */
+	TArray<int32> TileParents;
+
+	/** Plan of each live tile, indexed by plan index, kept to publish map snapshots. */
+	TArray<FTilePlan> TilePlans;
+
+	/** Number of live tiles that have arrived, which may trail the plan array while tiles arrive out of order. */
+	int32 ArrivedTileCount = 0;
+
+	/** True if tiles have arrived since the last snapshot was published. */
+	bool bSnapshotDirty = false;
+
+	/** Location of each live tile, indexed by plan index. Unset for tiles yet to arrive. */
+	TArray<TOptional<FVector>> TileLocations;
+
+	/** Graph distance from the focus tile to each live tile, indexed by plan index. */
+	TArray<int32> TileDistances;
+
+	/** World bounds of each loaded tile level, indexed by plan index. */
+	TArray<TOptional<FBox>> TileBoxes;
+
+	/** Live tiles from which streaming distances are measured. */
+	TArray<int32> FocusTiles;
+
+	/** View locations of the local players when the focus tiles were last found. */
+	TArray<FVector> FocusViewLocations;
+
+	/** True while an active stream that should be loaded has yet to have its bounds computed. */
+	bool bBoundsPending = false;
+
+	/** Stream last evicted to meet the memory budget, until its level has left the world. */
+	UPROPERTY()
+	TObjectPtr<UTilePlanStream> BudgetEvictedStream;
+
+	/** Streaming timestamps of a live tile, in platform seconds. Zero until the event occurs. */
+	struct FTileTiming
+	{
+		double QueueTime = 0;
+		double RequestTime = 0;
+		double LoadedTime = 0;
+		double VisibleTime = 0;
+	};
+
+	/** Streaming timestamps of each live tile, indexed by plan index. */
+	TArray<FTileTiming> TileTimings;
+
+	/** Platform time at which the active map began streaming. */
+	double MapStartTime = 0;
+
+	/** Number of tiles the active map is expected to contain. */
+	int32 ExpectedTileCount = 0;
+
+	/** True once the active map has become ready. */
+	bool bMapReady = false;
+
+	/** True if tiles have been added since the streaming distances were computed. */
+	bool bDistancesDirty = false;
+
+	/** Replicated tile map component for the world. */
+	TWeakObjectPtr<UTileMapComponent> MapComponent;
+
+	/** Door actors in the world, keyed by door index. */
+	TMap<int32, TWeakObjectPtr<ATileDoorBase>> Doors;
 };